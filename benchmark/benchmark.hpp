@@ -0,0 +1,50 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+namespace bench
+{
+    // Minimal timing helpers shared by benchmark executables. Benchmarks are plain programs that
+    // print one line per measurement. They do not depend on any benchmarking framework.
+
+    // Returns average time in nanoseconds of one iteration of the operation.
+    template<typename operation_type>
+    double measure(std::size_t iterations, operation_type&& operation)
+    {
+        // Warm up caches and branch predictors before the measurement
+        for (std::size_t i = 0; i < iterations / 10 + 1; ++i)
+            operation();
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+            operation();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / iterations;
+    }
+
+    // Prevents compiler from optimizing out the value
+    template<typename value_type>
+    void do_not_optimize(const value_type& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+}
@@ -0,0 +1,136 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <libmodules/emitter.hpp>
+#include <libmodules/receiver.hpp>
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+using namespace mtl;
+
+struct bench_signals
+{
+    virtual ~bench_signals() {}
+    virtual void tick(int value) = 0;
+    virtual void other(int value) = 0;
+};
+
+struct bench_receiver
+    : public receiver<bench_signals>
+{
+    int sum = 0;
+    void tick(int value) override { sum += value; }
+    void other(int) override {}
+};
+
+// Measures the cost of one send and the cost of one delivery for different fan-out sizes. Cost of
+// one delivery should stay flat while fan-out grows. Sending should not pay for the list cleanup
+// if nothing was detached. The churn column detaches and attaches one receiver between sends.
+void fan_out_benchmark()
+{
+    std::printf("%10s %14s %18s %18s\n", "fan-out", "ns/send", "ns/delivery", "ns/delivery+churn");
+    for (std::size_t fan_out : {1, 4, 16, 64, 256, 1024, 4096, 16384}) {
+        emitter<bench_signals> em;
+        std::vector<std::unique_ptr<bench_receiver>> receivers;
+        for (std::size_t i = 0; i < fan_out; ++i) {
+            receivers.push_back(std::make_unique<bench_receiver>());
+            em.attach(*receivers.back());
+        }
+
+        std::size_t iterations = 4000000 / fan_out + 100;
+        double send_time = bench::measure(iterations, [&] { em.send(&bench_signals::tick, 1); });
+
+        std::size_t churn_index = 0;
+        double churn_time = bench::measure(iterations, [&] {
+            bench_receiver& r = *receivers[churn_index++ % fan_out];
+            em.detach(r);
+            em.send(&bench_signals::tick, 1);
+            em.attach(r);
+        });
+
+        for (auto& r : receivers)
+            bench::do_not_optimize(r->sum);
+        std::printf("%10zu %14.1f %18.3f %18.3f\n", fan_out, send_time, send_time / fan_out, churn_time / fan_out);
+    }
+}
+
+// Measures sending of the signal that only each 16th receiver is interested in. Receivers are
+// attached to all signals or subscribed to the signal they are interested in.
+void subscription_benchmark()
+{
+    std::printf("\n%10s %18s %18s\n", "fan-out", "ns/send attached", "ns/send subscribed");
+    for (std::size_t fan_out : {64, 1024, 16384}) {
+        emitter<bench_signals> attached, subscribed;
+        std::vector<std::unique_ptr<bench_receiver>> receivers;
+        for (std::size_t i = 0; i < fan_out; ++i) {
+            receivers.push_back(std::make_unique<bench_receiver>());
+            attached.attach(*receivers.back());
+            if (i % 16)
+                subscribed.attach(*receivers.back(), &bench_signals::other);
+            else
+                subscribed.attach(*receivers.back(), &bench_signals::tick);
+        }
+
+        std::size_t iterations = 4000000 / fan_out + 100;
+        double attached_time = bench::measure(iterations, [&] { attached.send(&bench_signals::other, 1); });
+        double subscribed_time = bench::measure(iterations, [&] { subscribed.send(&bench_signals::tick, 1); });
+        std::printf("%10zu %18.1f %18.1f\n", fan_out, attached_time, subscribed_time);
+    }
+}
+
+// Measures the burst of 1000 signals sent one by one and by send_many in both delivery orders
+void burst_benchmark()
+{
+    std::printf("\n%10s %14s %18s %18s\n", "fan-out", "ns/signal send", "ns/signal signal", "ns/signal receiver");
+    const std::size_t burst = 1000;
+    std::vector<std::tuple<int>> ticks(burst, std::tuple<int>(1));
+    for (std::size_t fan_out : {1, 16, 256}) {
+        emitter<bench_signals> em;
+        std::vector<std::unique_ptr<bench_receiver>> receivers;
+        for (std::size_t i = 0; i < fan_out; ++i) {
+            receivers.push_back(std::make_unique<bench_receiver>());
+            em.attach(*receivers.back());
+        }
+
+        std::size_t iterations = 4000 / fan_out + 10;
+        double send_time = bench::measure(iterations, [&] {
+            for (auto& tick : ticks)
+                em.send(&bench_signals::tick, std::get<0>(tick));
+        });
+        double signal_time = bench::measure(iterations, [&] { em.send_many(&bench_signals::tick, ticks); });
+        double receiver_time = bench::measure(iterations, [&] {
+            em.send_many(&bench_signals::tick, ticks, delivery_order::receiver_major);
+        });
+
+        for (auto& r : receivers)
+            bench::do_not_optimize(r->sum);
+        std::printf("%10zu %14.2f %18.2f %18.2f\n", fan_out, send_time / burst, signal_time / burst, receiver_time / burst);
+    }
+}
+
+int main()
+{
+    fan_out_benchmark();
+    subscription_benchmark();
+    burst_benchmark();
+    return 0;
+}
@@ -0,0 +1,79 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <libmodules/emitter.hpp>
+#include <libmodules/receiver.hpp>
+#include <libmodules/thread_pool.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+
+struct bench_signals
+{
+    virtual ~bench_signals() {}
+    virtual void analyze(unsigned seed) = 0;
+};
+
+// Receiver that performs some expensive computation for each signal
+struct bench_receiver
+    : public receiver<bench_signals>
+{
+    unsigned result = 0;
+    void analyze(unsigned seed) override
+    {
+        unsigned value = seed;
+        for (int i = 0; i < 20000; ++i)
+            value = value * 1664525u + 1013904223u;
+        result += value;
+    }
+};
+
+// Measures broadcasting of the expensive signal to 256 receivers by send() and by send_parallel()
+// with thread pools of different sizes.
+int main()
+{
+    const std::size_t fan_out = 256;
+    emitter<bench_signals> em;
+    std::vector<std::unique_ptr<bench_receiver>> receivers;
+    for (std::size_t i = 0; i < fan_out; ++i) {
+        receivers.push_back(std::make_unique<bench_receiver>());
+        em.attach(*receivers.back());
+    }
+
+    double sequential_time = bench::measure(20, [&] { em.send(&bench_signals::analyze, 1u); });
+    std::printf("%10s %14s %10s\n", "pool size", "us/send", "speedup");
+    std::printf("%10s %14.1f %10.2f\n", "send", sequential_time / 1000, 1.0);
+
+    std::size_t max_threads = std::max(8u, std::thread::hardware_concurrency());
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        // Calling thread takes part in the execution too
+        thread_pool pool(threads);
+        double parallel_time = bench::measure(20, [&] { em.send_parallel(pool, &bench_signals::analyze, 1u); });
+        std::printf("%10zu %14.1f %10.2f\n", threads, parallel_time / 1000, sequential_time / parallel_time);
+    }
+
+    for (auto& r : receivers)
+        bench::do_not_optimize(r->result);
+    return 0;
+}
@@ -0,0 +1,177 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+
+#include "benchmark.hpp"
+
+#include <libmodules/proxy_receiver.hpp>
+#include <libmodules/receiver.hpp>
+#include <libmodules/threaded_receiver.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+
+struct bench_signals
+{
+    virtual ~bench_signals() {}
+    virtual void consume(unsigned value) = 0;
+};
+
+struct bench_receiver
+    : public receiver<bench_signals>
+{
+    unsigned result = 0;
+    void consume(unsigned value) override { result += value; }
+};
+
+// Returns average time in nanoseconds per signal passed from the producer thread to the consumer
+// thread through the queue receiver. Producer retries when the bounded queue is full.
+template<typename queue_type, typename transmit_type>
+double transfer(queue_type& queue, std::size_t count, transmit_type&& transmit)
+{
+    bench_receiver r;
+    queue.attach(r);
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&] {
+        packed_signal<bench_signals> call(&bench_signals::consume, 1u);
+        for (std::size_t i = 0; i < count; ++i)
+            while (!transmit(call))
+                std::this_thread::yield();
+    });
+    for (std::size_t received = 0; received < count;)
+        if (queue.pop_signal())
+            ++received;
+        else
+            std::this_thread::yield();
+    producer.join();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    bench::do_not_optimize(r.result);
+    queue.detach(r);
+    return elapsed.count() / count;
+}
+
+// Returns average time in nanoseconds per signal passed from many producer threads to the
+// consumer thread. Each producer transmits the same number of signals.
+template<typename queue_type>
+double fan_in(queue_type& queue, std::size_t producers, std::size_t count)
+{
+    bench_receiver r;
+    queue.attach(r);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t producer = 0; producer < producers; ++producer)
+        threads.emplace_back([&] {
+            packed_signal<bench_signals> call(&bench_signals::consume, 1u);
+            for (std::size_t i = 0; i < count / producers; ++i)
+                queue.transmit_signal(call);
+        });
+    for (std::size_t received = 0; received < count / producers * producers;)
+        if (queue.pop_signal())
+            ++received;
+        else
+            std::this_thread::yield();
+    for (auto& producer : threads)
+        producer.join();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    bench::do_not_optimize(r.result);
+    queue.detach(r);
+    return elapsed.count() / count;
+}
+
+// Measures signal throughput of the mutex guarded queue receiver and the lock-free receivers.
+int main()
+{
+    const std::size_t count = 2000000;
+    std::printf("%26s %10s %14s\n", "queue", "ns/signal", "signals/s");
+
+    queue_proxy_receiver<bench_signals, std::mutex> mutex_queue;
+    double mutex_time = transfer(mutex_queue, count, [&](const packed_signal<bench_signals>& call) {
+        mutex_queue.transmit_signal(call);
+        return true;
+    });
+    std::printf("%26s %10.1f %14.0f\n", "queue_proxy_receiver", mutex_time, 1e9 / mutex_time);
+
+    spsc_queue_proxy_receiver<bench_signals> spsc_queue(1024);
+    double spsc_time = transfer(spsc_queue, count, [&](const packed_signal<bench_signals>& call) {
+        try {
+            spsc_queue.transmit_signal(call);
+            return true;
+        }
+        catch (const signal_queue_overflow&) {
+            return false;
+        }
+    });
+    std::printf("%26s %10.1f %14.0f\n", "spsc_queue_proxy_receiver", spsc_time, 1e9 / spsc_time);
+
+    // Consumer side cost of 10k queued signals popped one by one and drained by one batch
+    const std::size_t batch_size = 10000;
+    bench_receiver r;
+    mutex_queue.attach(r);
+    packed_signal<bench_signals> call(&bench_signals::consume, 1u);
+    auto fill = [&] {
+        for (std::size_t i = 0; i < batch_size; ++i)
+            mutex_queue.transmit_signal(call);
+    };
+    double pop_time = bench::measure(100, [&] { fill(); while (mutex_queue.pop_signal()); });
+    double drain_time = bench::measure(100, [&] { fill(); mutex_queue.drain_all(); });
+    mutex_queue.detach(r);
+
+    typed_queue_proxy_receiver<bench_signals, signal_list<&bench_signals::consume>, std::mutex> typed_queue;
+    typed_queue.attach(r);
+    double typed_time = bench::measure(100, [&] {
+        for (std::size_t i = 0; i < batch_size; ++i)
+            typed_queue.transmit_signal(&bench_signals::consume, 1u);
+        typed_queue.drain_all();
+    });
+    typed_queue.detach(r);
+
+    std::printf("\n%26s %10s\n", "10k signals", "ns/signal");
+    std::printf("%26s %10.1f\n", "push + pop_signal", pop_time / batch_size);
+    std::printf("%26s %10.1f\n", "push + drain_all", drain_time / batch_size);
+    std::printf("%26s %10.1f\n", "typed push + drain_all", typed_time / batch_size);
+
+    // Producer side cost of transmission to the running active object with queue nodes
+    // allocated on demand and preallocated
+    for (std::size_t preallocated : {std::size_t(0), std::size_t(65536)}) {
+        threaded_receiver<bench_signals> worker(preallocated);
+        bench_receiver worker_receiver;
+        worker.attach(worker_receiver);
+        worker.start();
+        double enqueue_time = bench::measure(count, [&] { worker.transmit_signal(call); });
+        worker.stop();
+        bench::do_not_optimize(worker_receiver.result);
+        std::printf("%19s %6zu %10.1f\n", "threaded enqueue", preallocated, enqueue_time);
+    }
+
+    std::printf("\n%10s %16s %16s\n", "producers", "mutex ns/signal", "mpsc ns/signal");
+    for (std::size_t producers = 2; producers <= 16; producers *= 2) {
+        queue_proxy_receiver<bench_signals, std::mutex> contended_queue;
+        mpsc_queue_proxy_receiver<bench_signals> mpsc_queue;
+        double contended_time = fan_in(contended_queue, producers, count);
+        double mpsc_time = fan_in(mpsc_queue, producers, count);
+        std::printf("%10zu %16.1f %16.1f\n", producers, contended_time, mpsc_time);
+    }
+    return 0;
+}
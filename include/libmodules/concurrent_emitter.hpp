@@ -0,0 +1,330 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+#pragma once
+
+#include "emitter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mtl
+{
+    // Concurrent emitter is the emitter that could be used by multiple threads at once. Any
+    // thread could send signals while other threads attach and detach transmitters.
+    //
+    //   Broadcasting loop doesn't take any lock. It iterates the immutable snapshot of the
+    // transmitter array. Snapshot is protected by two reader counters switched by epoch, so the
+    // loop just increments and decrements one counter. Attach and detach are serialized by the
+    // mutex. They copy the snapshot, publish the new one and wait until all loops started before
+    // the publication are finished. After that the old snapshot is deleted. This is the same
+    // grace period technique that is used by user space RCU.
+    //
+    //   Detach doesn't return until all broadcasting loops that could deliver a signal to the
+    // detached transmitter are finished, so transmitter could be destroyed right after it. The
+    // only exception is the detach called from the broadcasting loop of this emitter. Waiting
+    // for other loops could lead to the deadlock there, so it only guarantees that no new
+    // deliveries to the transmitter are started.
+    //
+    //   Transmitter should be attached, detached and destroyed in the thread that owns it, since
+    // the list of its attachments is not synchronized. Transmitter should be detached explicitly
+    // by detach() or reset() before it is destroyed. The automatic release from the transmitter
+    // destructor happens after the derived receiver is destroyed, while other threads could still
+    // deliver signals to it. It is asserted in debug builds.
+    //
+    //   Reset and destruction of the emitter unlink all attached transmitters, so they should not
+    // be called while the owners of these transmitters change their attachments. Both wait for
+    // the broadcasting loops like detach. Emitter itself should be destroyed when no one sends
+    // signals by it. Emitter can't be copied or moved.
+    template<typename signal_table>
+    class concurrent_emitter
+        : private attachment_owner<signal_table>
+    {
+        using owner_type = attachment_owner<signal_table>;
+        using transmitter_type = transmitter<signal_table>;
+        using attachment_type = attachment<signal_table>;
+
+        // Record is never moved, so transmitter could be linked to it while other threads change
+        // the emitter. Broadcasting loop reads only constant fields and the attachment flag.
+        // Released record is kept in the snapshot until the snapshot is compacted.
+        struct record
+        {
+            record(transmitter_type& transmitter, concurrent_emitter& owner) noexcept
+                : transmitter(&transmitter)
+                , receiver(transmitter.get())
+                , link(transmitter, owner)
+            {}
+
+            transmitter_type* const transmitter;
+            signal_table* const receiver;
+            attachment_type link;
+            std::atomic<bool> is_attached{true};
+        };
+
+        using snapshot = std::vector<std::shared_ptr<record>>;
+
+        // Read section is placed at the stack by each broadcasting loop. Sections of the thread
+        // are chained to let writer know if it is called from the broadcasting loop.
+        class read_section
+        {
+        public:
+            explicit read_section(const concurrent_emitter& owner) noexcept
+                : _owner(owner)
+                , _parity(owner._epoch.load() & 1)
+                , _outer(sections)
+            {
+                owner._readers[_parity].fetch_add(1);
+                sections = this;
+            }
+
+            ~read_section() noexcept
+            {
+                sections = _outer;
+                _owner._readers[_parity].fetch_sub(1);
+            }
+
+            read_section(const read_section&) = delete;
+            read_section& operator =(const read_section&) = delete;
+
+            static bool entered(const concurrent_emitter& owner) noexcept
+            {
+                for (const read_section* section = sections; section; section = section->_outer)
+                    if (&section->_owner == &owner)
+                        return true;
+                return false;
+            }
+
+        private:
+            static inline thread_local const read_section* sections = nullptr;
+
+            const concurrent_emitter& _owner;
+            const unsigned _parity;
+            const read_section* _outer;
+        };
+
+        // Publish the new snapshot and retire the current one. Released records are dropped.
+        // Caller should hold the writer lock.
+        void publish(std::unique_ptr<snapshot> next)
+        {
+            next->erase(std::remove_if(next->begin(), next->end(),
+                                       [](const std::shared_ptr<record>& item) { return !item->is_attached.load(); }),
+                        next->end());
+            _released = 0;
+            if (snapshot* previous = _snapshot.exchange(next.release()))
+                _retired.emplace_back(previous);
+        }
+
+        std::unique_ptr<snapshot> copy_snapshot() const
+        {
+            const snapshot* current = _snapshot.load();
+            auto next = std::make_unique<snapshot>();
+            next->reserve((current ? current->size() : 0) + 1);
+            if (current)
+                *next = *current;
+            return next;
+        }
+
+        // Wait until all broadcasting loops started before this call are finished and delete
+        // snapshots retired before it. It should not be called from the broadcasting loop.
+        void synchronize() noexcept
+        {
+            std::lock_guard<std::mutex> grace_lock(_grace);
+            std::vector<std::unique_ptr<snapshot>> retired;
+            {
+                std::lock_guard<std::mutex> lock(_writer);
+                retired.swap(_retired);
+            }
+
+            // Loop could take the parity before the first switch and increment the counter
+            // after the wait, so both counters are waited.
+            for (int pass = 0; pass < 2; ++pass) {
+                unsigned parity = _epoch.fetch_add(1) & 1;
+                while (_readers[parity].load())
+                    std::this_thread::yield();
+            }
+        }
+
+        // Mark record as released. Record that is already released by reset() is skipped.
+        // Caller should hold the writer lock.
+        void release_record(attachment_type& link) noexcept
+        {
+            for (const auto& item : *_snapshot.load())
+                if (&item->link == &link) {
+                    if (!item->is_attached.exchange(false))
+                        return;
+                    owner_type::reset(link);
+                    --_size;
+                    ++_released;
+                    return;
+                }
+        }
+
+        void release(attachment_type& link) noexcept override
+        {
+            {
+                std::lock_guard<std::mutex> lock(_writer);
+                release_record(link);
+            }
+            if (!read_section::entered(*this))
+                synchronize();
+        }
+
+        void release_destroyed(attachment_type& link) noexcept override
+        {
+            assert(!"Transmitter should be detached from the concurrent emitter before destruction.");
+            release(link);
+        }
+
+    public:
+        concurrent_emitter() noexcept = default;
+
+        ~concurrent_emitter() noexcept
+        {
+            std::unique_ptr<snapshot> current;
+            {
+                std::lock_guard<std::mutex> lock(_writer);
+                current.reset(_snapshot.exchange(nullptr));
+                if (current)
+                    for (const auto& item : *current)
+                        if (item->is_attached.exchange(false))
+                            owner_type::reset(item->link);
+                _size = 0;
+            }
+            // Wait for the loops that are still finishing before the snapshots are deleted
+            synchronize();
+        }
+
+        concurrent_emitter(const concurrent_emitter&) = delete;
+        concurrent_emitter& operator =(const concurrent_emitter&) = delete;
+
+        void attach(transmitter_type& transmitter)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_writer);
+                auto next = copy_snapshot();
+                next->push_back(std::make_shared<record>(transmitter, *this));
+                publish(std::move(next));
+                ++_size;
+            }
+            // Delete the old snapshot. Loop of this emitter keeps using it, so deletion is
+            // postponed until the next change made outside of the loop.
+            if (!read_section::entered(*this))
+                synchronize();
+        }
+
+        // Detach the latest attachment of the transmitter. The snapshot is compacted when the
+        // half of it is released.
+        void detach(transmitter_type& transmitter)
+        {
+            attachment_type* link = this->find(transmitter);
+            if (!link)
+                throw transmitter_not_attached("Unable to detach transmitter that was not attached.");
+
+            {
+                std::lock_guard<std::mutex> lock(_writer);
+                release_record(*link);
+                if (_released > _size)
+                    publish(copy_snapshot());
+            }
+            if (!read_section::entered(*this))
+                synchronize();
+        }
+
+        // Detach all transmitters
+        void reset()
+        {
+            std::unique_ptr<snapshot> next = std::make_unique<snapshot>();
+            {
+                std::lock_guard<std::mutex> lock(_writer);
+                if (snapshot* current = _snapshot.load())
+                    for (const auto& item : *current)
+                        if (item->is_attached.exchange(false))
+                            owner_type::reset(item->link);
+                _size = 0;
+                publish(std::move(next));
+            }
+            if (!read_section::entered(*this))
+                synchronize();
+        }
+
+        std::size_t size() const noexcept { return _size.load(); }
+        bool empty() const noexcept { return !size(); }
+
+        // Arguments are passed to receivers as lvalues, rvalue arguments are never moved out.
+        // Transmitters attached while broadcasting is in progress don't receive the signal.
+        template<typename FnType, typename... Args>
+        bool send(FnType signal_name, Args&&... args)
+        {
+            read_section section(*this);
+            const snapshot* transmitters = _snapshot.load();
+            if (!transmitters)
+                return true;
+
+            packed_signal<signal_table> call;
+            for (const auto& item : *transmitters) {
+                if (!item->is_attached.load())
+                    continue;
+
+                // Send signal directly if transmitter provides receiver
+                if (auto* receiver = item->receiver) {
+                    (receiver->*signal_name)(args...);
+                }
+                // Send packed signal in other case.
+                else {
+                    if (!call)
+                        call = packed_signal<signal_table>(signal_name, args...);
+                    item->transmitter->transmit_signal(call);
+                }
+            }
+            return true;
+        }
+
+        bool send(const packed_signal<signal_table>& call)
+        {
+            if (!call)
+                return true;
+
+            read_section section(*this);
+            const snapshot* transmitters = _snapshot.load();
+            if (!transmitters)
+                return true;
+
+            for (const auto& item : *transmitters)
+                if (item->is_attached.load())
+                    item->transmitter->transmit_signal(call);
+            return true;
+        }
+
+    private:
+        std::atomic<snapshot*> _snapshot{nullptr};
+        std::atomic<std::size_t> _size{0};
+        std::size_t _released = 0;
+        std::vector<std::unique_ptr<snapshot>> _retired;
+        std::mutex _writer;
+        // Grace periods are serialized to let each of them switch the epoch twice in a row
+        std::mutex _grace;
+        std::atomic<unsigned> _epoch{0};
+        mutable std::atomic<std::size_t> _readers[2] = {};
+    };
+} // namespace mtl
@@ -0,0 +1,173 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+#pragma once
+
+#include "emitter.hpp"
+#include "signal_queue.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace mtl
+{
+    // Dispatcher runs many queue receivers on the shared work stealing thread pool (see
+    // thread_pool.hpp) instead of one thread per receiver.
+    //
+    //   Dispatched receiver queues transmitted signals in the lock-free queue. The receiver that
+    // gets the first signal becomes ready and posts one task to the pool. The task resends up to
+    // batch size signals and posts itself again if there are more signals. Otherwise receiver
+    // becomes idle. So, idle receivers cost nothing and each receiver is run by at most one
+    // thread at a time like a strand. Different receivers run in parallel.
+    class dispatcher
+    {
+    public:
+        explicit dispatcher(std::size_t thread_count = std::thread::hardware_concurrency())
+            : _pool(thread_count)
+        {}
+
+        // Destructor finishes tasks of ready receivers. Receivers should be destroyed before it.
+        ~dispatcher() = default;
+
+        dispatcher(const dispatcher&) = delete;
+        dispatcher& operator =(const dispatcher&) = delete;
+
+        thread_pool& pool() noexcept { return _pool; }
+
+        // Number of receivers that have posted tasks
+        std::size_t ready() const noexcept { return _ready.load(); }
+
+    private:
+        template<typename signal_table>
+        friend class dispatched_receiver;
+
+        thread_pool _pool;
+        std::atomic<std::size_t> _ready{0};
+    };
+
+    // Dispatched receiver resends signals from the threads of the dispatcher. Attached
+    // transmitters are called by one thread at a time, but it could be different threads. They
+    // should be attached and detached before signals are transmitted to the receiver or by the
+    // receiver itself.
+    //
+    // Destructor detaches receiver from emitters, stops accepting signals and waits until
+    // transmissions in progress and its task are finished. Signals transmitted by other threads
+    // while it runs are dropped. Nothing should be transmitted to the receiver after destructor
+    // returns. Receiver could be destroyed by the thread of the dispatcher, it runs pending tasks
+    // of the pool while waiting, but it should not be destroyed by its own signals. Exception
+    // thrown by the attached transmitter terminates the program.
+    template<typename signal_table>
+    class dispatched_receiver
+        : public transmitter<signal_table>
+        , public emitter<signal_table>
+    {
+    public:
+        // Batch size limits number of signals resent by one task. Queue nodes for the preallocated
+        // number of signals are allocated at once, see mpsc_signal_queue.
+        explicit dispatched_receiver(dispatcher& owner, std::size_t batch_size = 64, std::size_t preallocated = 0)
+            : _dispatcher(owner)
+            , _batch_size(batch_size ? batch_size : 1)
+            , _signals(preallocated)
+        {}
+
+        ~dispatched_receiver() noexcept
+        {
+            this->transmitter<signal_table>::reset();
+            // Producer that has passed the check schedules the task before it leaves push
+            _is_closed.store(true);
+            while (_producers.load())
+                std::this_thread::yield();
+            // Task could be queued to the worker that runs this destructor
+            while (_tasks.load())
+                if (!_dispatcher._pool.run_pending())
+                    std::this_thread::yield();
+        }
+
+        dispatched_receiver(const dispatched_receiver&) = delete;
+        dispatched_receiver& operator =(const dispatched_receiver&) = delete;
+
+        virtual void transmit_signal(const packed_signal<signal_table>& call) { push(call); }
+        virtual void transmit_signal(packed_signal<signal_table>&& call)      { push(std::move(call)); }
+
+        // Receiver is ready while it has pending signals and the task posted to the pool
+        bool ready() const noexcept { return !!_pending.load(); }
+
+    private:
+        void push(packed_signal<signal_table> call)
+        {
+            _producers.fetch_add(1);
+            if (!_is_closed.load()) {
+                _signals.push(std::move(call));
+                // The first pending signal makes receiver ready
+                if (!_pending.fetch_add(1))
+                    schedule(false);
+            }
+            _producers.fetch_sub(1);
+        }
+
+        void schedule(bool is_continued)
+        {
+            _tasks.fetch_add(1);
+            auto task = [this] { run(); };
+            // Continued task yields to other tasks of the worker
+            if (is_continued) {
+                _dispatcher._pool.defer(task);
+            }
+            else {
+                _dispatcher._ready.fetch_add(1);
+                _dispatcher._pool.post(task);
+            }
+        }
+
+        void run()
+        {
+            // Signal is counted after it is pushed, so pending signals could be popped. Signal of
+            // the producer that is pushing it right now could be not seen yet, it is popped by
+            // the continued task.
+            std::size_t limit = std::min(_batch_size, _pending.load());
+            std::size_t count = 0;
+            packed_signal<signal_table> call;
+            while (count < limit && _signals.pop(call)) {
+                ++count;
+                this->send(std::move(call));
+                call.reset();
+            }
+
+            // Receiver becomes idle when the last pending signal is processed. Producer that
+            // pushes the next signal schedules it again.
+            if (_pending.fetch_sub(count) != count)
+                schedule(true);
+            else
+                _dispatcher._ready.fetch_sub(1);
+            // It is the last access to this receiver
+            _tasks.fetch_sub(1);
+        }
+
+        dispatcher& _dispatcher;
+        const std::size_t _batch_size;
+        mpsc_signal_queue<signal_table> _signals;
+        std::atomic<std::size_t> _pending{0};
+        // Number of posted tasks that are not finished yet
+        std::atomic<std::size_t> _tasks{0};
+        // Number of threads that are pushing signals right now
+        std::atomic<std::size_t> _producers{0};
+        std::atomic<bool> _is_closed{false};
+    };
+} // namespace mtl
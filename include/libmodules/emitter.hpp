@@ -19,9 +19,15 @@ License.
 
 #include "signal.hpp"
 
-#include <vector>
-#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace mtl
 {
@@ -36,123 +42,677 @@ namespace mtl
         using std::logic_error::logic_error;
     };
 
+    // Order of delivery of many signals sent by one call
+    enum class delivery_order
+    {
+        signal_major,   // Each signal is delivered to all transmitters before the next one
+        receiver_major, // All signals are delivered to each transmitter before the next one
+    };
+
     template<typename signal_table>
     class emitter
-        : private enable_spying<emitter<signal_table>>
     {
-        using handle_type = spy_pointer<emitter<signal_table>>;
         using transmitter_type = transmitter<signal_table>;
 
-        friend handle_type;
+        // Send guard is placed at the stack by each broadcasting loop to catch self destruction
+        // inside the loop. Guards of recursive loops are chained from the innermost one to the
+        // outermost. Emitter resets all guards in the chain at the destruction moment. It is
+        // cheaper than spy pointer to self instance: just two pointer writes per loop.
+        class send_guard
+        {
+        public:
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic push
+// Guard unlinks itself in the destructor unless the emitter is destroyed, GCC can't see it.
+#pragma GCC diagnostic ignored "-Wdangling-pointer"
+#endif
+            explicit send_guard(emitter& owner) noexcept
+                : _owner(&owner)
+                , _outer(owner._guards)
+            {
+                owner._guards = this;
+            }
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic pop
+#endif
+
+            ~send_guard() noexcept
+            {
+                if (!_owner)
+                    return;
+
+                _owner->_guards = _outer;
+                // Cleanup detached receivers int the receivers list when last recursive
+                // operation finishes.
+                if (!_outer)
+                    _owner->cleanup();
+            }
+
+            send_guard(const send_guard&) = delete;
+            send_guard& operator =(const send_guard&) = delete;
+
+            // Check if emitter is still alive
+            explicit operator bool() const noexcept { return !!_owner; }
+
+        private:
+            friend class emitter;
+
+            emitter* _owner;
+            send_guard* _outer;
+        };
+
+        // Signal method bound to the arguments shared between all packed copies of the signal
+        template<typename FnType, typename payload_type>
+        struct shared_signal
+        {
+            FnType _signal;
+            std::shared_ptr<const payload_type> _payload;
+
+            void operator()(signal_table& table) const
+            {
+                std::apply([&](const auto&... values) { (table.*_signal)(values...); }, *_payload);
+            }
+
+            signal_id<signal_table> signal() const noexcept { return _signal; }
+        };
+
+        // Arguments produced by the lazy argument producer. Tuple is the list of arguments.
+        template<typename result_type>
+        struct lazy_payload
+        {
+            using type = std::tuple<result_type>;
+            static type make(result_type&& result) { return type(std::move(result)); }
+        };
+
+        template<typename... Args>
+        struct lazy_payload<std::tuple<Args...>>
+        {
+            using type = std::tuple<Args...>;
+            static type make(type&& result) { return std::move(result); }
+        };
+
+        // Transmitters subscribed to the particular signal of the table
+        struct signal_transmitters
+        {
+            signal_id<signal_table> signal;
+            transmitter_list<signal_table> transmitters;
+        };
+
+        // Transmitters that receive all signals
+        transmitter_list<signal_table> _transmitters;
+        // Per signal lists of subscribed transmitters. Lists are allocated separately to keep them
+        // in place while new signal is subscribed in the middle of broadcasting.
+        std::vector<std::unique_ptr<signal_transmitters>> _signals;
+        // The innermost active broadcasting loop
+        send_guard* _guards = nullptr;
+
+        // State of the active parallel broadcasting shared by its tasks. Lock serializes changes
+        // of attachments made by receivers in parallel and reading of attachments by tasks.
+        struct parallel_state
+        {
+            std::recursive_mutex lock;
+            bool is_alive = true;
+        };
+        parallel_state* _parallel = nullptr;
+
+        // Notify all active broadcasting loops that they should stop
+        void release_guards() noexcept
+        {
+            for (send_guard* guard = std::exchange(_guards, nullptr); guard; guard = guard->_outer)
+                guard->_owner = nullptr;
+
+            if (parallel_state* parallel = std::exchange(_parallel, nullptr)) {
+                std::lock_guard<std::recursive_mutex> lock(parallel->lock);
+                parallel->is_alive = false;
+                share_lists(nullptr);
+            }
+        }
+
+        // Make releases of attachments take the lock of parallel broadcasting
+        void share_lists(std::recursive_mutex* lock) noexcept
+        {
+            _transmitters.set_release_lock(lock);
+            for (auto& subscription : _signals)
+                subscription->transmitters.set_release_lock(lock);
+        }
+
+        // Lock that serializes changes of attachments while parallel broadcasting is in progress
+        std::unique_lock<std::recursive_mutex> lock_parallel()
+        {
+            if (!_parallel)
+                return std::unique_lock<std::recursive_mutex>();
+            return std::unique_lock<std::recursive_mutex>(_parallel->lock);
+        }
+
+        // Released attachments are removed from the list only when at least half of it is
+        // released. So, compaction cost is amortized by detach operations and sending without
+        // detaches pays nothing.
+        static void cleanup(transmitter_list<signal_table>& transmitters) noexcept
+        {
+            if (transmitters.released() > transmitters.size())
+                transmitters.compact();
+        }
+
+        void cleanup() noexcept
+        {
+            cleanup(_transmitters);
+            for (auto& subscription : _signals)
+                cleanup(subscription->transmitters);
+        }
+
+        transmitter_list<signal_table>* find_signal(signal_id<signal_table> signal) const noexcept
+        {
+            if (!signal)
+                return nullptr;
+            for (auto& subscription : _signals)
+                if (subscription->signal == signal)
+                    return &subscription->transmitters;
+            return nullptr;
+        }
+
+        // Performs delivery for each transmitter attached to all signals and then for each
+        // transmitter subscribed to the signal. Lists are iterated by index up to the size captured
+        // before the loop, because they could grow while sending. Transmitters attached in the
+        // middle of broadcasting are skipped.
+        // Returns false in case of self destruction.
+        template<typename delivery_type>
+        bool broadcast(const send_guard& self, const transmitter_list<signal_table>* subscribers,
+                       delivery_type&& delivery)
+        {
+            const transmitter_list<signal_table>* lists[] = { &_transmitters, subscribers };
+
+            // The last attached transmitter could get rvalue arguments
+            const transmitter_list<signal_table>* last_list = nullptr;
+            std::size_t last_index = 0;
+            for (const auto* transmitters : lists)
+                if (transmitters)
+                    for (std::size_t i = transmitters->end_index(); i-- > 0;)
+                        if ((*transmitters)[i]) {
+                            last_list = transmitters;
+                            last_index = i;
+                            break;
+                        }
+
+            for (const auto* transmitters : lists) {
+                if (!transmitters)
+                    continue;
 
-        std::vector<spy_pointer<transmitter_type>> _transmitters;
+                std::size_t count = transmitters->end_index();
+                for (std::size_t i = 0; i < count; ++i) {
+                    auto& attachment = (*transmitters)[i];
+                    if (!attachment)
+                        continue;
+
+                    delivery(attachment, transmitters == last_list && i == last_index);
+
+                    // Break broadcasting loop in case if self destruction.
+                    if (!self)
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        // Deliver shared arguments. Signal is packed once for all transmitters without receiver.
+        template<typename FnType, typename payload_type>
+        static void deliver_shared(const attachment<signal_table>& attachment, FnType signal_name,
+                                   const std::shared_ptr<const payload_type>& payload, packed_signal<signal_table>& call)
+        {
+            // Send signal directly if transmitter provides receiver
+            if (auto* receiver = attachment.receiver()) {
+                std::apply([&](const auto&... values) { (receiver->*signal_name)(values...); }, *payload);
+            }
+            // Send packed signal in other case.
+            else {
+                if (!call)
+                    call = packed_signal<signal_table>(shared_signal<FnType, payload_type>{signal_name, payload});
+                attachment.get()->transmit_signal(call);
+            }
+        }
 
-        void on_spying_state_changed() noexcept
+        // Rvalue arguments could be moved out only by the last transmitter in the loop. The rest
+        // of transmitters get lvalues if signal accepts them. Arguments that can't be passed as
+        // lvalues are delivered to the single transmitter only, since the second one would get
+        // moved out values.
+        template<typename FnType, typename... Args>
+        static void deliver(signal_table* receiver, bool is_last, FnType signal_name, Args&&... args)
         {
-            // Do nothing in case if new broadcasting loop begins.
-            if (sending())
-                return;
+            if (!is_last) {
+                if constexpr (std::is_invocable_v<FnType, signal_table*, Args&...>) {
+                    (receiver->*signal_name)(args...);
+                    return;
+                }
+                else {
+                    throw signal_not_copyable("Unable to send move-only arguments to multiple transmitters.");
+                }
+            }
+            (receiver->*signal_name)(std::forward<Args>(args)...);
+        }
 
-            // Cleanup detached receivers int the receivers list when last recursive operation
-            // finishes.
-            _transmitters.erase(std::remove(_transmitters.begin(), _transmitters.end(), nullptr),
-                             _transmitters.end());
+        template<typename FnType, typename... Args>
+        static packed_signal<signal_table> pack(bool is_last, FnType signal_name, Args&&... args)
+        {
+            if (!is_last) {
+                if constexpr ((std::is_constructible_v<std::decay_t<Args>, Args&> && ...))
+                    return packed_signal<signal_table>(signal_name, args...);
+                else
+                    throw signal_not_copyable("Unable to send move-only arguments to multiple transmitters.");
+            }
+            return packed_signal<signal_table>(signal_name, std::forward<Args>(args)...);
         }
 
     public:
-        void attach(transmitter_type& transmitter)
+        // Copy and move operations copy or move attachments but not the state of broadcasting
+        // loops. Loops of the moved and assigned emitters are stopped like they were destroyed.
+        emitter() noexcept = default;
+        emitter(const emitter& other) { *this = other; }
+        emitter(emitter&& other) noexcept { *this = std::move(other); }
+        ~emitter() noexcept { release_guards(); }
+
+        emitter& operator =(const emitter& other)
         {
-            _transmitters.push_back(&transmitter);
+            if (this == &other)
+                return *this;
+
+            release_guards();
+            _transmitters = other._transmitters;
+            _signals.clear();
+            for (auto& subscription : other._signals)
+                _signals.push_back(std::make_unique<signal_transmitters>(*subscription));
+            return *this;
+        }
+
+        emitter& operator =(emitter&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            release_guards();
+            other.release_guards();
+            _transmitters = std::move(other._transmitters);
+            _signals = std::move(other._signals);
+            other._signals.clear();
+            return *this;
         }
 
-        void detach(transmitter_type& transmitter)
+        // Attach transmitter to receive all signals of the table or only specified signals:
+        //   attach(transmitter);
+        //   attach(transmitter, &signal_table::first_signal, &signal_table::second_signal);
+        // Transmitter subscribed to the particular signals is not disturbed by the rest of them.
+        // Packed signals are transmitted to the subscribers only if they were packed from the
+        // signal method.
+        template<typename... FnTypes>
+        void attach(transmitter_type& transmitter, FnTypes... signal_names)
         {
-            auto it = std::find(_transmitters.rbegin(), _transmitters.rend(), &transmitter);
-            if (it == _transmitters.rend())
+            auto lock = lock_parallel();
+            if constexpr (!sizeof...(FnTypes))
+                _transmitters.attach(transmitter);
+            else
+                (subscribe(transmitter, signal_names), ...);
+        }
+
+        // Detach the transmitter attached to all signals. If there is no such attachment, detach
+        // all subscriptions of the transmitter to the particular signals. Signals could be
+        // specified to detach subscriptions only from them.
+        template<typename... FnTypes>
+        void detach(transmitter_type& transmitter, FnTypes... signal_names)
+        {
+            auto lock = lock_parallel();
+            bool is_detached = true;
+            if constexpr (!sizeof...(FnTypes)) {
+                is_detached = _transmitters.detach(transmitter);
+                if (!is_detached)
+                    for (auto& subscription : _signals)
+                        while (subscription->transmitters.detach(transmitter))
+                            is_detached = true;
+            }
+            else {
+                auto unsubscribe = [&](signal_id<signal_table> signal) {
+                    auto* transmitters = find_signal(signal);
+                    return transmitters && transmitters->detach(transmitter);
+                };
+                is_detached = (unsubscribe(signal_names) & ...);
+            }
+
+            if (!is_detached)
                 throw transmitter_not_attached("Unable to detach transmitter that was not attached.");
 
-            // Handle spy pointer to self instance to cleanup transmitters list at the end of all
-            // recursive broadcasting and detaching processes.
-            handle_type self(this);
-            it->reset();
+            if (!sending())
+                cleanup();
         }
 
-        bool empty()
+        bool empty() const noexcept { return !size(); }
+
+        // Number of attachments. Transmitter subscribed to multiple signals is counted once for
+        // each signal.
+        std::size_t size() const noexcept
         {
-            for (auto& transmitter : _transmitters)
-                if (transmitter)
-                    return false;
-            return true;
+            std::size_t result = _transmitters.size();
+            for (auto& subscription : _signals)
+                result += subscription->transmitters.size();
+            return result;
         }
 
         void reset()
         {
-            // Handle spy pointer to self instance to cleanup transmitters list at the end of all
-            // recursive broadcasting and detaching processes.
-            handle_type self(this);
-
-            for (auto& transmitter : _transmitters)
-                transmitter.reset();
+            auto lock = lock_parallel();
+            _transmitters.clear();
+            for (auto& subscription : _signals)
+                subscription->transmitters.clear();
+            if (!sending())
+                cleanup();
         }
 
-        bool sending() { return !enable_spying<emitter<signal_table>>::empty(); }
+        bool sending() const noexcept { return !!_guards; }
 
+        // Arguments are passed to receivers as lvalues. The rvalue argument is forwarded only to the
+        // last transmitter, so no receiver gets the moved-from value. Arguments are packed once for
+        // all transmitters that have no receiver. Transmitters attached to all signals receive the
+        // signal before transmitters subscribed to this signal. Arguments that can't be passed as
+        // lvalues or copied could be sent to one transmitter only, otherwise signal_not_copyable is
+        // thrown.
         template<typename FnType, typename... Args>
         bool send(FnType signal_name, Args&&... args)
         {
-            // Handle spy pointer to self instance to catch self destruction inside the
-            // broadcasting loop.
-            handle_type self(this);
+            // Place guard to catch self destruction inside the broadcasting loop.
+            send_guard self(*this);
             packed_signal<signal_table> call;
+            auto* subscribers = find_signal(signal_name);
 
-            // Do not use iterators here because _transmitters could grow.
-            size_t count = _transmitters.size();
-            for (size_t i = 0; i < count; ++i) {
-                auto& transmitter = _transmitters[i];
-                if (!transmitter)
-                    continue;
-
+            auto delivery = [&](const attachment<signal_table>& attachment, bool may_move) {
                 // Send signal directly if transmitter provides receiver
-                if (transmitter->get()) {
-                    (transmitter->get()->*signal_name)(std::forward<Args>(args)...);
+                if (auto* receiver = attachment.receiver()) {
+                    deliver(receiver, may_move, signal_name, std::forward<Args>(args)...);
                 }
                 // Send packed signal in other case.
                 else {
                     if (!call)
-                        call = std::bind(signal_name, std::placeholders::_1, std::forward<Args>(args)...);
-                    transmitter->transmit_signal(call);
+                        call = pack(may_move, signal_name, std::forward<Args>(args)...);
+                    if (may_move)
+                        attachment.get()->transmit_signal(std::move(call));
+                    else
+                        attachment.get()->transmit_signal(call);
                 }
+            };
 
-                // Break broadcasting loop in case if self destruction.
-                if (!self)
+            return broadcast(self, subscribers, delivery);
+        }
+
+        // Shared broadcasting mode for large arguments. Arguments are materialized exactly once
+        // into the immutable payload. Receivers get const references to the payload values.
+        // Transmitters without receiver get packed signal that shares the payload by reference
+        // counter, so copying the signal into queues does not copy arguments. Signal methods
+        // should accept arguments by value or by const reference. Use std::ref to pass mutable
+        // reference.
+        template<typename FnType, typename... Args>
+        bool send_shared(FnType signal_name, Args&&... args)
+        {
+            auto* subscribers = find_signal(signal_name);
+            if (_transmitters.empty() && (!subscribers || subscribers->empty()))
+                return true;
+
+            using payload_type = std::tuple<std::decay_t<Args>...>;
+            auto payload = std::make_shared<const payload_type>(std::forward<Args>(args)...);
+
+            // Place guard to catch self destruction inside the broadcasting loop.
+            send_guard self(*this);
+            packed_signal<signal_table> call;
+
+            auto delivery = [&](const attachment<signal_table>& attachment, bool) {
+                deliver_shared(attachment, signal_name, payload, call);
+            };
+
+            return broadcast(self, subscribers, delivery);
+        }
+
+        // Lazy broadcasting mode for arguments that are expensive to build. Producer is called
+        // without arguments and returns the signal argument or std::tuple of arguments. It is
+        // called at most once right before the first delivery, so nothing is built if no
+        // transmitter is attached to the signal. Arguments are shared like send_shared() does.
+        template<typename FnType, typename producer_type>
+        bool send_lazy(FnType signal_name, producer_type&& producer)
+        {
+            auto* subscribers = find_signal(signal_name);
+            if (_transmitters.empty() && (!subscribers || subscribers->empty()))
+                return true;
+
+            using result_type = std::decay_t<std::invoke_result_t<producer_type&>>;
+            using payload_type = typename lazy_payload<result_type>::type;
+            std::shared_ptr<const payload_type> payload;
+
+            // Place guard to catch self destruction inside the broadcasting loop.
+            send_guard self(*this);
+            packed_signal<signal_table> call;
+
+            auto delivery = [&](const attachment<signal_table>& attachment, bool) {
+                if (!payload)
+                    payload = std::make_shared<const payload_type>(lazy_payload<result_type>::make(producer()));
+                deliver_shared(attachment, signal_name, payload, call);
+            };
+
+            return broadcast(self, subscribers, delivery);
+        }
+
+        // Burst broadcasting mode. Each element of the range is a tuple of arguments of one
+        // signal. Broadcasting bookkeeping is done once for the whole range. Arguments are passed
+        // to receivers as lvalues. Transmitters that have no receiver get signals packed once per
+        // element, in receiver major order they get all of them by one transmit_batch() call.
+        template<typename FnType, typename range_type>
+        bool send_many(FnType signal_name, const range_type& arguments, delivery_order order = delivery_order::signal_major)
+        {
+            // Place guard to catch self destruction inside the broadcasting loop.
+            send_guard self(*this);
+            auto* subscribers = find_signal(signal_name);
+
+            if (order == delivery_order::receiver_major) {
+                std::vector<packed_signal<signal_table>> calls;
+                auto delivery = [&](const attachment<signal_table>& attachment, bool) {
+                    // Send signals directly if transmitter provides receiver
+                    if (auto* receiver = attachment.receiver()) {
+                        for (const auto& item : arguments) {
+                            std::apply([&](const auto&... args) { (receiver->*signal_name)(args...); }, item);
+                            if (!self)
+                                return;
+                        }
+                    }
+                    // Send packed signals in other case.
+                    else {
+                        if (calls.empty())
+                            for (const auto& item : arguments)
+                                std::apply([&](const auto&... args) { calls.emplace_back(signal_name, args...); }, item);
+                        attachment.get()->transmit_batch(calls);
+                    }
+                };
+                return broadcast(self, subscribers, delivery);
+            }
+
+            for (const auto& item : arguments) {
+                packed_signal<signal_table> call;
+                auto delivery = [&](const attachment<signal_table>& attachment, bool) {
+                    // Send signal directly if transmitter provides receiver
+                    if (auto* receiver = attachment.receiver()) {
+                        std::apply([&](const auto&... args) { (receiver->*signal_name)(args...); }, item);
+                    }
+                    // Send packed signal in other case.
+                    else {
+                        if (!call)
+                            call = std::apply([&](const auto&... args) { return packed_signal<signal_table>(signal_name, args...); }, item);
+                        attachment.get()->transmit_signal(call);
+                    }
+                };
+                if (!broadcast(self, subscribers, delivery))
                     return false;
             }
             return true;
         }
 
+        // Parallel broadcasting mode for expensive receivers with large fan-out. Transmitters are
+        // processed by the executor (see thread_pool.hpp), the method returns when all of them
+        // received the signal. Arguments are shared between threads as const references and
+        // packed at most once for transmitters that have no receiver. The first exception thrown
+        // by the receiver is rethrown when the broadcasting is finished.
+        //
+        // Receivers could attach, detach and destroy transmitters and destroy this emitter. Such
+        // changes are serialized by the lock of the broadcasting. Each task checks under the lock
+        // that the emitter is alive and its transmitter is still attached right before the
+        // delivery, so detached and destroyed transmitters don't receive the signal if their
+        // delivery is not started yet. Transmitter should not be destroyed while another thread
+        // delivers the signal to it. Receivers should not send signals by this emitter while
+        // broadcasting.
+        template<typename executor_type, typename FnType, typename... Args>
+        bool send_parallel(executor_type& executor, FnType signal_name, const Args&... args)
+        {
+            // Place guard to catch self destruction inside the broadcasting loop.
+            send_guard self(*this);
+            auto* subscribers = find_signal(signal_name);
+
+            // Emitter could be destroyed by the receiver, so section uses only the state after it
+            struct parallel_section
+            {
+                emitter& owner;
+                parallel_state state;
+
+                explicit parallel_section(emitter& owner) : owner(owner)
+                {
+                    owner._parallel = &state;
+                    owner.share_lists(&state.lock);
+                }
+
+                ~parallel_section()
+                {
+                    if (!state.is_alive)
+                        return;
+                    owner.share_lists(nullptr);
+                    owner._parallel = nullptr;
+                }
+            } section(*this);
+
+            packed_signal<signal_table> call;
+            std::once_flag is_packed;
+
+            std::size_t count = _transmitters.end_index();
+            std::size_t subscribers_count = subscribers ? subscribers->end_index() : 0;
+            executor.bulk_execute(count + subscribers_count, [&](std::size_t index) {
+                transmitter_type* transmitter = nullptr;
+                signal_table* receiver = nullptr;
+                {
+                    std::lock_guard<std::recursive_mutex> lock(section.state.lock);
+                    if (!section.state.is_alive)
+                        return;
+
+                    auto& attachment = index < count ? _transmitters[index] : (*subscribers)[index - count];
+                    if (!attachment)
+                        return;
+                    transmitter = attachment.get();
+                    receiver = attachment.receiver();
+                }
+
+                // Send signal directly if transmitter provides receiver
+                if (receiver) {
+                    (receiver->*signal_name)(args...);
+                }
+                // Send packed signal in other case.
+                else {
+                    std::call_once(is_packed, [&] { call = packed_signal<signal_table>(signal_name, args...); });
+                    transmitter->transmit_signal(call);
+                }
+            });
+            return !!self;
+        }
+
         bool send(const packed_signal<signal_table>& call)
         {
             if (!call)
                 return true;
-            
-            // Handle spy pointer to self instance to catch self destruction inside the
-            // broadcasting loop.
-            handle_type self(this);
-
-            // Do not use iterators here because _transmitters could grow.
-            for (size_t i = 0; i < _transmitters.size(); ++i) {
-                auto& transmitter = _transmitters[i];
-                if (!transmitter)
-                    continue;
 
-                // Send packed signal.
-                transmitter->transmit_signal(call);
+            // Place guard to catch self destruction inside the broadcasting loop.
+            send_guard self(*this);
+            auto* subscribers = find_signal(call.signal());
+
+            auto delivery = [&](const attachment<signal_table>& attachment, bool) {
+                attachment.get()->transmit_signal(call);
+            };
+
+            return broadcast(self, subscribers, delivery);
+        }
+
+        // Batch broadcasting mode for queued signals. Each transmitter attached to all signals
+        // gets the whole batch by one transmit_batch() call. Transmitters subscribed to the
+        // particular signals get them one by one after that.
+        bool send_batch(std::span<const packed_signal<signal_table>> calls)
+        {
+            if (calls.empty())
+                return true;
+
+            // Place guard to catch self destruction inside the broadcasting loop.
+            send_guard self(*this);
+            std::size_t count = _transmitters.end_index();
+            for (std::size_t i = 0; i < count; ++i) {
+                auto& attachment = _transmitters[i];
+                if (!attachment)
+                    continue;
 
-                // Break broadcasting loop in case of self destruction.
+                attachment.get()->transmit_batch(calls);
                 if (!self)
                     return false;
             }
+
+            if (_signals.empty())
+                return true;
+
+            for (const auto& call : calls) {
+                const transmitter_list<signal_table>* subscribers = find_signal(call.signal());
+                if (!subscribers)
+                    continue;
+
+                count = subscribers->end_index();
+                for (std::size_t i = 0; i < count; ++i) {
+                    auto& attachment = (*subscribers)[i];
+                    if (!attachment)
+                        continue;
+
+                    attachment.get()->transmit_signal(call);
+                    if (!self)
+                        return false;
+                }
+            }
             return true;
         }
+
+        // Packed signal is moved to the last transmitter, so signal with move-only arguments
+        // could be sent to one transmitter.
+        bool send(packed_signal<signal_table>&& call)
+        {
+            if (!call)
+                return true;
+
+            // Place guard to catch self destruction inside the broadcasting loop.
+            send_guard self(*this);
+            auto* subscribers = find_signal(call.signal());
+
+            auto delivery = [&](const attachment<signal_table>& attachment, bool may_move) {
+                if (may_move)
+                    attachment.get()->transmit_signal(std::move(call));
+                else
+                    attachment.get()->transmit_signal(call);
+            };
+
+            return broadcast(self, subscribers, delivery);
+        }
+
+    private:
+        template<typename FnType>
+        void subscribe(transmitter_type& transmitter, FnType signal_name)
+        {
+            auto* transmitters = find_signal(signal_name);
+            if (!transmitters) {
+                _signals.push_back(std::make_unique<signal_transmitters>());
+                _signals.back()->signal = signal_name;
+                transmitters = &_signals.back()->transmitters;
+                if (_parallel)
+                    transmitters->set_release_lock(&_parallel->lock);
+            }
+            transmitters->attach(transmitter);
+        }
     };
 } // namespace mtl
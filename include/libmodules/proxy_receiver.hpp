@@ -19,10 +19,29 @@ License.
 
 #include "emitter.hpp"
 #include "lockable.hpp"
+#include "signal_queue.hpp"
 #include "spy_pointer.hpp"
+#include "timer_wheel.hpp"
+#include "wait_strategy.hpp"
 
-#include <queue>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace mtl
 {
@@ -39,6 +58,8 @@ namespace mtl
     {
     public:
         virtual void transmit_signal(const packed_signal<signal_table>& call) { this->send(call); }
+        virtual void transmit_signal(packed_signal<signal_table>&& call)      { this->send(std::move(call)); }
+        virtual void transmit_batch(std::span<const packed_signal<signal_table>> calls) { this->send_batch(calls); }
     };
 
     // Filter receiver is able to filter or change signal while transferring. It inherit
@@ -80,27 +101,540 @@ namespace mtl
     // Warning: pointers and references stored in signal arguments could be invalidated before
     // the signal is executed. Your could send data by value or use shared pointer to handle
     // such situations.
+    //
+    // Signals could be popped one by one or drained by batches. Consumer swaps the whole queue
+    // with the consumer side batch under one lock when the batch is empty and transmits the batch
+    // without lock. So pop and drain should be called by one consumer thread at a time. Queue
+    // and batch keep their capacity, it could be preallocated by reserve().
+    //
+    // Consumer could wait for signals by wait_pop() and wait_pop_for(). Waiting is performed by
+    // the wait strategy (see wait_strategy.hpp). Waiting consumer could be woken up without
+    // signal by wakeup(). Shutdown wakes up all consumers and makes further waits return
+    // immediately when the queue is empty. Waiting requires the real locker, since signals are
+    // transmitted by other threads then.
 
-    template<typename signal_table, typename locker_type = no_lockable>
+    template<typename signal_table, typename locker_type = no_lockable, typename wait_strategy_type = spin_yield_wait>
     class queue_proxy_receiver
         : public transmitter<signal_table>
         , public emitter<signal_table>
     {
-        std::queue<packed_signal<signal_table>> _signal_queue;
+        std::vector<packed_signal<signal_table>> _signal_queue;
+        // Consumer side buffer that is not protected by the locker
+        std::vector<packed_signal<signal_table>> _batch;
+        std::size_t _batch_head = 0;
         locker_type _locker;
+        wait_strategy_type _waiter;
+        bool _is_woken_up = false;
+        bool _is_shut_down = false;
+
+        bool wait_pop_until(wait_clock::time_point deadline)
+        {
+            static_assert(!std::is_same_v<locker_type, no_lockable>,
+                          "Waiting for signals requires the locker shared with producer threads.");
+
+            _waiter.wait_until([this] {
+                if (_batch_head < _batch.size())
+                    return true;
+                std::lock_guard<locker_type> lock(_locker);
+                return !_signal_queue.empty() || _is_woken_up || _is_shut_down;
+            }, deadline);
+
+            if (pop_signal())
+                return true;
+
+            std::lock_guard<locker_type> lock(_locker);
+            _is_woken_up = false;
+            return false;
+        }
+
+        // Take signals of the queue if the batch is empty. Both buffers keep their capacity, so
+        // steady queuing doesn't allocate memory.
+        bool fill_batch()
+        {
+            if (_batch_head == _batch.size()) {
+                _batch.clear();
+                _batch_head = 0;
+                std::lock_guard<locker_type> lock(_locker);
+                _batch.swap(_signal_queue);
+            }
+            return _batch_head < _batch.size();
+        }
+
+        // Transmit up to max_count signals of the batch while is_in_time() returns true.
+        template<typename time_check_type>
+        std::size_t drain_batch(std::size_t max_count, time_check_type is_in_time)
+        {
+            std::size_t count = 0;
+            while (count < max_count && fill_batch()) {
+                packed_signal<signal_table> call;
+                call.swap(_batch[_batch_head++]);
+                ++count;
+                // Stop if receiver was destroyed by the signal
+                if (!this->send(std::move(call)))
+                    return count;
+                if (!is_in_time())
+                    break;
+            }
+            return count;
+        }
 
     public:
-        queue_proxy_receiver(locker_type locker = locker_type()) : _locker(locker) {}
+        queue_proxy_receiver() = default;
+        queue_proxy_receiver(locker_type locker) : _locker(std::move(locker)) {}
         queue_proxy_receiver(const queue_proxy_receiver& other) = default;
         queue_proxy_receiver(queue_proxy_receiver&& other) = default;
 
 
+        virtual void transmit_signal(const packed_signal<signal_table>& call)
+        {
+            {
+                std::lock_guard<locker_type> lock(_locker);
+                _signal_queue.push_back(call);
+            }
+            _waiter.notify_one();
+        }
+
+        virtual void transmit_signal(packed_signal<signal_table>&& call)
+        {
+            {
+                std::lock_guard<locker_type> lock(_locker);
+                _signal_queue.push_back(std::move(call));
+            }
+            _waiter.notify_one();
+        }
+
+        bool pop_signal()
+        {
+            if (!fill_batch())
+                return false;
+
+            packed_signal<signal_table> call;
+            call.swap(_batch[_batch_head++]);
+            this->send(std::move(call));
+            return true;
+        }
+
+        // Transmit up to max_count queued signals by one batch (see emitter::send_batch). Returns
+        // number of transmitted signals. Receivers should not pop signals of this queue while
+        // they process the batch.
+        std::size_t pop_batch(std::size_t max_count = std::numeric_limits<std::size_t>::max())
+        {
+            if (!fill_batch())
+                return 0;
+
+            std::size_t count = std::min(max_count, _batch.size() - _batch_head);
+            std::span<packed_signal<signal_table>> calls(_batch.data() + _batch_head, count);
+            _batch_head += count;
+            // Stop if receiver was destroyed by the batch
+            if (!this->send_batch(calls))
+                return count;
+
+            for (auto& call : calls)
+                call.reset();
+            return count;
+        }
+
+        // Preallocate buffers for the given number of queued signals. It should be called by the
+        // consumer thread.
+        void reserve(std::size_t count)
+        {
+            _batch.reserve(count);
+            std::lock_guard<locker_type> lock(_locker);
+            _signal_queue.reserve(count);
+        }
+
+        // Transmit up to max_count queued signals. Returns number of transmitted signals.
+        std::size_t drain(std::size_t max_count)
+        {
+            return drain_batch(max_count, [] { return true; });
+        }
+
+        // Transmit up to max_count queued signals until the time budget is exhausted. At least
+        // one signal is transmitted if the queue is not empty.
+        template<typename rep_type, typename period_type>
+        std::size_t drain(std::size_t max_count, std::chrono::duration<rep_type, period_type> budget)
+        {
+            auto deadline = std::chrono::steady_clock::now() + budget;
+            return drain_batch(max_count, [deadline] { return std::chrono::steady_clock::now() < deadline; });
+        }
+
+        // Transmit all signals queued before the call. Signals transmitted by receivers during
+        // the drain are left for the next call.
+        std::size_t drain_all()
+        {
+            std::size_t count = _batch.size() - _batch_head;
+            {
+                std::lock_guard<locker_type> lock(_locker);
+                count += _signal_queue.size();
+            }
+            return drain_batch(count, [] { return true; });
+        }
+
+        // Wait for the signal and transmit it. Returns false if consumer was woken up or queue
+        // was shut down while the queue is empty.
+        bool wait_pop() { return wait_pop_until(wait_clock::time_point::max()); }
+
+        // The same as wait_pop() but returns false when timeout is expired too
+        template<typename rep_type, typename period_type>
+        bool wait_pop_for(std::chrono::duration<rep_type, period_type> timeout)
+        {
+            return wait_pop_until(wait_clock::now() + timeout);
+        }
+
+        // Wake up one waiting consumer or make the next wait return false immediately
+        void wakeup()
+        {
+            {
+                std::lock_guard<locker_type> lock(_locker);
+                _is_woken_up = true;
+            }
+            _waiter.notify_one();
+        }
+
+        void shutdown()
+        {
+            {
+                std::lock_guard<locker_type> lock(_locker);
+                _is_shut_down = true;
+            }
+            _waiter.notify_all();
+        }
+
+        bool is_shut_down()
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            return _is_shut_down;
+        }
+
+        wait_strategy_type& wait_strategy() noexcept { return _waiter; }
+    };
+
+    // Typed queue receiver stores signals of the listed methods without type erasure (see
+    // typed_signal_queue in signal_queue.hpp). Signal list is signal_list<&signal_table::name...>.
+    // Packed signals transmitted by emitter are unpacked into the queue, and signals could be
+    // queued without packing by transmit_signal(signal_name, args...). Popped signals are sent
+    // by the signal method, so receivers are called directly.
+    //
+    //   Consumer swaps the queue with the consumer side batch like queue receiver does, so pop
+    // and drain should be called by one consumer thread at a time.
+
+    template<typename signal_table, typename signal_list_type, typename locker_type = no_lockable>
+    class typed_queue_proxy_receiver
+        : public transmitter<signal_table>
+        , public emitter<signal_table>
+    {
+        using queue_type = typed_signal_queue<signal_table, signal_list_type>;
+
+        queue_type _signal_queue;
+        // Consumer side buffer that is not protected by the locker
+        queue_type _batch;
+        locker_type _locker;
+
+        bool fill_batch()
+        {
+            if (_batch.empty()) {
+                std::lock_guard<locker_type> lock(_locker);
+                _batch.swap(_signal_queue);
+            }
+            return !_batch.empty();
+        }
+
+        // Transmit the next signal of the batch. Returns false if receiver was destroyed by it.
+        bool transmit_next()
+        {
+            bool is_alive = true;
+            _batch.pop([&](auto&&... signal) { is_alive = this->send(std::forward<decltype(signal)>(signal)...); });
+            return is_alive;
+        }
+
+    public:
         virtual void transmit_signal(const packed_signal<signal_table>& call)
         {
             std::lock_guard<locker_type> lock(_locker);
             _signal_queue.push(call);
         }
 
+        virtual void transmit_signal(packed_signal<signal_table>&& call)
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            _signal_queue.push(std::move(call));
+        }
+
+        template<typename FnType, typename... Args,
+                 typename = std::enable_if_t<std::is_member_function_pointer_v<FnType>>>
+        void transmit_signal(FnType signal_name, Args&&... args)
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            _signal_queue.push(signal_name, std::forward<Args>(args)...);
+        }
+
+        bool pop_signal()
+        {
+            if (!fill_batch())
+                return false;
+
+            transmit_next();
+            return true;
+        }
+
+        // Transmit all signals queued before the call. Returns number of transmitted signals.
+        std::size_t drain_all()
+        {
+            std::size_t limit = _batch.size();
+            {
+                std::lock_guard<locker_type> lock(_locker);
+                limit += _signal_queue.size();
+            }
+
+            std::size_t count = 0;
+            while (count < limit && fill_batch()) {
+                ++count;
+                // Stop if receiver was destroyed by the signal
+                if (!transmit_next())
+                    break;
+            }
+            return count;
+        }
+
+        std::size_t size()
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            return _batch.size() + _signal_queue.size();
+        }
+    };
+
+    // Priority queue receiver keeps separate FIFO queue for each priority level. Level 0 has the
+    // highest priority. Priority could be assigned to the signal method by set_priority() or to
+    // the particular transmission. Unknown signals get the default priority.
+    //
+    // Pop takes the signal of the highest priority non-empty level. To avoid starvation, the
+    // non-empty level that was bypassed starvation_limit times in a row is served first. Priority
+    // of the signal method is found by the hash table and the level is found by the bit mask of
+    // non-empty levels, so push and pop take constant time.
+
+    template<typename signal_table, std::size_t levels = 3, typename locker_type = no_lockable>
+    class priority_queue_proxy_receiver
+        : public transmitter<signal_table>
+        , public emitter<signal_table>
+    {
+        static_assert(levels > 0 && levels <= 32, "Priority queue supports from 1 to 32 levels.");
+
+    public:
+        explicit priority_queue_proxy_receiver(std::size_t default_priority = levels - 1, std::size_t starvation_limit = 16)
+            : _default_priority(std::min(default_priority, levels - 1))
+            , _starvation_limit(starvation_limit ? starvation_limit : 1)
+        {}
+
+        // Assign priority to the signal method
+        template<typename FnType>
+        void set_priority(FnType signal_name, std::size_t priority)
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            _priorities[signal_id<signal_table>(signal_name)] = std::min(priority, levels - 1);
+        }
+
+        virtual void transmit_signal(const packed_signal<signal_table>& call)
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            push(call, priority_of(call.signal()));
+        }
+
+        virtual void transmit_signal(packed_signal<signal_table>&& call)
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            std::size_t priority = priority_of(call.signal());
+            push(std::move(call), priority);
+        }
+
+        // Transmit signal with the particular priority
+        void transmit_signal(const packed_signal<signal_table>& call, std::size_t priority)
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            push(call, std::min(priority, levels - 1));
+        }
+
+        void transmit_signal(packed_signal<signal_table>&& call, std::size_t priority)
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            push(std::move(call), std::min(priority, levels - 1));
+        }
+
+        bool pop_signal()
+        {
+            packed_signal<signal_table> call;
+            {
+                std::lock_guard<locker_type> lock(_locker);
+                if (!_ready)
+                    return false;
+
+                std::size_t level = select_level();
+                _levels[level].pop(call);
+                if (_levels[level].empty())
+                    _ready &= ~(1u << level);
+            } // ~lock_guard to release queue while call is transmitted
+            this->send(std::move(call));
+            return true;
+        }
+
+        std::size_t size()
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            std::size_t result = 0;
+            for (auto& level : _levels)
+                result += level.size();
+            return result;
+        }
+
+    private:
+        std::size_t priority_of(signal_id<signal_table> signal) const noexcept
+        {
+            auto found = _priorities.find(signal);
+            return found != _priorities.end() ? found->second : _default_priority;
+        }
+
+        void push(packed_signal<signal_table> call, std::size_t priority)
+        {
+            _levels[priority].push(std::move(call));
+            if (!(_ready & (1u << priority))) {
+                _ready |= 1u << priority;
+                _bypassed[priority] = 0;
+            }
+        }
+
+        // Select the highest priority level or the starving one and count bypassed levels
+        std::size_t select_level() noexcept
+        {
+            std::size_t selected = static_cast<std::size_t>(std::countr_zero(_ready));
+            for (std::size_t level = selected + 1; level < levels; ++level)
+                if ((_ready & (1u << level)) && _bypassed[level] >= _starvation_limit) {
+                    selected = level;
+                    break;
+                }
+
+            _bypassed[selected] = 0;
+            for (std::size_t level = 0; level < levels; ++level)
+                if (level != selected && (_ready & (1u << level)))
+                    ++_bypassed[level];
+            return selected;
+        }
+
+        signal_ring<signal_table> _levels[levels];
+        std::size_t _bypassed[levels] = {};
+        std::uint32_t _ready = 0;
+        std::unordered_map<signal_id<signal_table>, std::size_t> _priorities;
+        const std::size_t _default_priority;
+        const std::size_t _starvation_limit;
+        locker_type _locker;
+    };
+
+    // Conflating queue receiver keeps only the latest pending signal for each key. Conflation is
+    // enabled for the signal method by conflate(), optionally with the key function that gets
+    // signal arguments like the signal method does. Key should be hashable by std::hash. Signal
+    // replaces the pending signal of the same method and key and takes its queue position. Other
+    // signals are queued as usual. So the number of pending conflated signals is bounded by the
+    // number of distinct keys, and consumer gets only the latest values.
+
+    template<typename signal_table, typename locker_type = no_lockable>
+    class conflating_queue_proxy_receiver
+        : public transmitter<signal_table>
+        , public emitter<signal_table>
+    {
+        using packed_type = packed_signal<signal_table>;
+
+        static constexpr std::uint64_t no_position = ~std::uint64_t(0);
+
+        // Rule remembers positions of the pending signals of one signal method
+        struct conflation_rule
+        {
+            virtual ~conflation_rule() {}
+
+            // Position of the pending signal with the same key. The new position is remembered
+            // if there is no such signal. Returns no_position if the signal could not be
+            // conflated.
+            virtual std::uint64_t find_or_insert(const packed_type& call, std::uint64_t position) = 0;
+            virtual void erase(const packed_type& call) = 0;
+        };
+
+        class signal_rule
+            : public conflation_rule
+        {
+        public:
+            std::uint64_t find_or_insert(const packed_type&, std::uint64_t position) override
+            {
+                if (_position == no_position)
+                    _position = position;
+                return _position;
+            }
+
+            void erase(const packed_type&) override { _position = no_position; }
+
+        private:
+            std::uint64_t _position = no_position;
+        };
+
+        template<typename signal_type, typename key_function>
+        class keyed_rule
+            : public conflation_rule
+        {
+            using key_type = std::decay_t<typename signal_traits<signal_type>::template invoke_result<key_function>>;
+
+        public:
+            keyed_rule(signal_type signal_name, key_function key_of)
+                : _signal(signal_name)
+                , _key_of(std::move(key_of))
+            {}
+
+            std::uint64_t find_or_insert(const packed_type& call, std::uint64_t position) override
+            {
+                std::optional<key_type> key = key_of(call);
+                if (!key)
+                    return no_position;
+                return _positions.try_emplace(std::move(*key), position).first->second;
+            }
+
+            void erase(const packed_type& call) override
+            {
+                if (std::optional<key_type> key = key_of(call))
+                    _positions.erase(*key);
+            }
+
+        private:
+            std::optional<key_type> key_of(const packed_type& call)
+            {
+                std::optional<key_type> key;
+                call.visit(_signal, [&](auto&&... args) { key.emplace(_key_of(std::forward<decltype(args)>(args)...)); });
+                return key;
+            }
+
+            signal_type _signal;
+            key_function _key_of;
+            std::unordered_map<key_type, std::uint64_t> _positions;
+        };
+
+        struct entry
+        {
+            packed_type call;
+            conflation_rule* rule;
+        };
+
+    public:
+        // Conflate all pending signals of the method
+        template<typename FnType>
+        void conflate(FnType signal_name)
+        {
+            add_rule(signal_name, std::make_unique<signal_rule>());
+        }
+
+        // Conflate pending signals of the method with the same key
+        template<typename FnType, typename key_function>
+        void conflate(FnType signal_name, key_function key_of)
+        {
+            add_rule(signal_name, std::make_unique<keyed_rule<FnType, key_function>>(signal_name, std::move(key_of)));
+        }
+
+        virtual void transmit_signal(const packed_signal<signal_table>& call) { push(call); }
+        virtual void transmit_signal(packed_signal<signal_table>&& call)      { push(std::move(call)); }
+
         bool pop_signal()
         {
             packed_signal<signal_table> call;
@@ -109,12 +643,411 @@ namespace mtl
                 if (_signal_queue.empty())
                     return false;
 
-                call.swap(_signal_queue.front());
-                _signal_queue.pop();
+                entry& front = _signal_queue.front();
+                if (front.rule)
+                    front.rule->erase(front.call);
+                call = std::move(front.call);
+                _signal_queue.pop_front();
+                ++_head;
+            } // ~lock_guard to release queue while call is transmitted
+            this->send(std::move(call));
+            return true;
+        }
+
+        std::size_t size()
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            return _signal_queue.size();
+        }
+
+        // Number of signals replaced by the newer ones
+        std::size_t conflated()
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            return _conflated;
+        }
+
+    private:
+        void push(packed_signal<signal_table> call)
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            std::uint64_t position = _head + _signal_queue.size();
+            conflation_rule* rule = rule_of(call.signal());
+            if (rule) {
+                std::uint64_t pending = rule->find_or_insert(call, position);
+                if (pending == no_position) {
+                    rule = nullptr;
+                }
+                else if (pending != position) {
+                    _signal_queue[pending - _head].call = std::move(call);
+                    ++_conflated;
+                    return;
+                }
+            }
+            _signal_queue.push_back(entry{std::move(call), rule});
+        }
+
+        template<typename FnType>
+        void add_rule(FnType signal_name, std::unique_ptr<conflation_rule> rule)
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            for (auto& item : _rules)
+                if (item.first == signal_id<signal_table>(signal_name))
+                    throw std::logic_error("Signal is already conflated.");
+            _rules.emplace_back(signal_name, std::move(rule));
+        }
+
+        conflation_rule* rule_of(signal_id<signal_table> signal) const noexcept
+        {
+            if (signal)
+                for (auto& item : _rules)
+                    if (item.first == signal)
+                        return item.second.get();
+            return nullptr;
+        }
+
+        std::deque<entry> _signal_queue;
+        // Position of the queue front. Positions of pending signals don't change when front is popped.
+        std::uint64_t _head = 0;
+        std::size_t _conflated = 0;
+        std::vector<std::pair<signal_id<signal_table>, std::unique_ptr<conflation_rule>>> _rules;
+        locker_type _locker;
+    };
+
+    // Overflow policy specifies what bounded queue receiver does with the signal transmitted to
+    // the full queue.
+    enum class overflow_policy
+    {
+        block,       // Wait until consumer pops a signal
+        fail,        // Throw signal_queue_overflow, so emitter send reports it to the caller
+        drop_newest, // Drop the transmitted signal
+        drop_oldest, // Drop the oldest queued signal and queue the transmitted one
+        spill,       // Pass the transmitted signal to the spill handler, e.g. secondary store
+    };
+
+    // Bounded queue receiver keeps at most capacity signals in the preallocated ring buffer. The
+    // signal transmitted to the full queue is handled by the overflow policy. Receiver counts
+    // dropped and rejected signals and remembers the maximal queue size.
+    //
+    // Locker should be compatible with std::condition_variable_any for the block policy. Spill
+    // handler is called without lock and takes the signal by value, so the signal transmitted as
+    // rvalue is moved to the secondary store.
+    //
+    //   Fail policy throws from the emitter broadcasting loop. The loop stops there, so
+    // transmitters attached after this receiver don't get the signal, while previous ones have
+    // already got it. Use drop or spill policy if other receivers should not depend on this one.
+
+    template<typename signal_table, typename locker_type = std::mutex>
+    class bounded_queue_proxy_receiver
+        : public transmitter<signal_table>
+        , public emitter<signal_table>
+    {
+    public:
+        using spill_handler = std::function<void(packed_signal<signal_table>)>;
+
+        explicit bounded_queue_proxy_receiver(std::size_t capacity,
+                                              overflow_policy policy = overflow_policy::fail,
+                                              spill_handler spill = spill_handler())
+            : _signals(capacity)
+            , _policy(policy)
+            , _spill(std::move(spill))
+        {
+            if (!capacity)
+                throw std::invalid_argument("Bounded queue requires non-zero capacity.");
+            if (policy == overflow_policy::spill && !_spill)
+                throw std::invalid_argument("Spill policy requires spill handler.");
+        }
+
+        virtual void transmit_signal(const packed_signal<signal_table>& call) { push(call); }
+        virtual void transmit_signal(packed_signal<signal_table>&& call)      { push(std::move(call)); }
+
+        bool pop_signal()
+        {
+            packed_signal<signal_table> call;
+            {
+                std::lock_guard<locker_type> lock(_locker);
+                if (!_size)
+                    return false;
+
+                call.swap(_signals[_head]);
+                _head = (_head + 1) % _signals.size();
+                --_size;
             } // ~lock_guard to release queue while call is transmitted
-            this->send(call);
+            if (_policy == overflow_policy::block)
+                _space.notify_one();
+            this->send(std::move(call));
             return true;
         }
+
+        std::size_t capacity() const noexcept { return _signals.size(); }
+
+        std::size_t size()
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            return _size;
+        }
+
+        // Number of signals dropped or rejected by overflow policy
+        std::size_t dropped()
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            return _dropped;
+        }
+
+        // Maximal number of queued signals
+        std::size_t high_water_mark()
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            return _high_water_mark;
+        }
+
+    private:
+        // Signal is copied or moved only if it is stored in the queue
+        template<typename call_type>
+        void push(call_type&& call)
+        {
+            std::unique_lock<locker_type> lock(_locker);
+            if (_size == _signals.size()) {
+                switch (_policy) {
+                case overflow_policy::block:
+                    _space.wait(lock, [this] { return _size < _signals.size(); });
+                    break;
+                case overflow_policy::fail:
+                    ++_dropped;
+                    throw signal_queue_overflow("Unable to transmit signal to the full queue.");
+                case overflow_policy::drop_newest:
+                    ++_dropped;
+                    return;
+                case overflow_policy::drop_oldest:
+                    ++_dropped;
+                    _signals[_head].reset();
+                    _head = (_head + 1) % _signals.size();
+                    --_size;
+                    break;
+                case overflow_policy::spill:
+                    lock.unlock();
+                    _spill(std::forward<call_type>(call));
+                    return;
+                }
+            }
+
+            _signals[(_head + _size) % _signals.size()] = std::forward<call_type>(call);
+            _high_water_mark = std::max(_high_water_mark, ++_size);
+        }
+
+        std::vector<packed_signal<signal_table>> _signals;
+        std::size_t _head = 0;
+        std::size_t _size = 0;
+        std::size_t _dropped = 0;
+        std::size_t _high_water_mark = 0;
+        const overflow_policy _policy;
+        spill_handler _spill;
+        locker_type _locker;
+        std::condition_variable_any _space;
+    };
+
+    // Bounded queue receiver for one producer thread and one consumer thread. It stores signals
+    // in the preallocated ring buffer without locks (see signal_queue.hpp). Signal is transmitted
+    // by one thread and popped by another one. Transmission to the full queue throws
+    // signal_queue_overflow.
+
+    template<typename signal_table>
+    class spsc_queue_proxy_receiver
+        : public transmitter<signal_table>
+        , public emitter<signal_table>
+    {
+        spsc_signal_queue<signal_table> _signal_queue;
+
+    public:
+        explicit spsc_queue_proxy_receiver(std::size_t capacity) : _signal_queue(capacity) {}
+
+        virtual void transmit_signal(const packed_signal<signal_table>& call)
+        {
+            if (!_signal_queue.push(call))
+                throw signal_queue_overflow("Unable to transmit signal to the full queue.");
+        }
+
+        virtual void transmit_signal(packed_signal<signal_table>&& call)
+        {
+            if (!_signal_queue.push(std::move(call)))
+                throw signal_queue_overflow("Unable to transmit signal to the full queue.");
+        }
+
+        bool pop_signal()
+        {
+            packed_signal<signal_table> call;
+            if (!_signal_queue.pop(call))
+                return false;
+
+            this->send(std::move(call));
+            return true;
+        }
+
+        std::size_t capacity() const noexcept { return _signal_queue.capacity(); }
+    };
+
+    // Unbounded queue receiver for many producer threads and one consumer thread. Producers
+    // never block each other (see signal_queue.hpp). Signals transmitted by one thread are
+    // popped in the same order.
+
+    template<typename signal_table>
+    class mpsc_queue_proxy_receiver
+        : public transmitter<signal_table>
+        , public emitter<signal_table>
+    {
+        mpsc_signal_queue<signal_table> _signal_queue;
+
+    public:
+        explicit mpsc_queue_proxy_receiver(std::size_t preallocated = 0) : _signal_queue(preallocated) {}
+
+        virtual void transmit_signal(const packed_signal<signal_table>& call) { _signal_queue.push(call); }
+        virtual void transmit_signal(packed_signal<signal_table>&& call)      { _signal_queue.push(std::move(call)); }
+
+        bool pop_signal()
+        {
+            packed_signal<signal_table> call;
+            if (!_signal_queue.pop(call))
+                return false;
+
+            this->send(std::move(call));
+            return true;
+        }
+    };
+
+    // Delayed receiver keeps signals until their deadline and transmits them by poll(). Signal
+    // could be scheduled to the time point, after the delay or periodically. Scheduled signal
+    // could be cancelled by the returned identifier. Signals are kept in the hierarchical timer
+    // wheel (see timer_wheel.hpp), so schedule and cancel take constant time.
+    //
+    //   Time is measured by the clock object in ticks of the given resolution. Signal is never
+    // transmitted before its deadline, and it is late for less than one tick if poll() is called
+    // each tick. Signal transmitted by the emitter is transmitted at the next tick. Clock could
+    // be replaced by any type that meets Clock requirements to control time in tests.
+    //
+    //   Poll should be called by one consumer thread at a time. Signals are transmitted without
+    // lock, so they could be scheduled and cancelled by the transmitted signals.
+
+    template<typename signal_table, typename clock_type = std::chrono::steady_clock, typename locker_type = no_lockable>
+    class delayed_proxy_receiver
+        : public transmitter<signal_table>
+        , public emitter<signal_table>
+    {
+        using wheel_type = timer_wheel<packed_signal<signal_table>>;
+
+    public:
+        using timer_id = typename wheel_type::timer_id;
+        using duration = typename clock_type::duration;
+        using time_point = typename clock_type::time_point;
+
+        explicit delayed_proxy_receiver(duration resolution = std::chrono::milliseconds(1), clock_type clock = clock_type())
+            : _clock(std::move(clock))
+            , _start(_clock.now())
+            , _resolution(resolution > duration::zero() ? resolution : duration(1))
+        {}
+
+        virtual void transmit_signal(const packed_signal<signal_table>& call)
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            _wheel.schedule(0, 0, call);
+        }
+
+        virtual void transmit_signal(packed_signal<signal_table>&& call)
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            _wheel.schedule(0, 0, std::move(call));
+        }
+
+        // Signals are taken by value, so move-only signals could be moved in
+        timer_id transmit_signal_at(packed_signal<signal_table> call, time_point deadline)
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            return _wheel.schedule(ticks_until(deadline), 0, std::move(call));
+        }
+
+        template<typename Rep, typename Period>
+        timer_id transmit_signal_after(packed_signal<signal_table> call, std::chrono::duration<Rep, Period> delay)
+        {
+            return transmit_signal_at(std::move(call), _clock.now() + std::chrono::ceil<duration>(delay));
+        }
+
+        // Transmit signal each period starting after the first delay. Period is rounded up to
+        // the whole number of ticks, and deadlines don't drift if poll is late. Periodic signal
+        // is copied for each transmission, so move-only signal is shared between the copies.
+        template<typename Rep, typename Period>
+        timer_id transmit_signal_every(packed_signal<signal_table> call, std::chrono::duration<Rep, Period> period)
+        {
+            return transmit_signal_every(std::move(call), period, period);
+        }
+
+        template<typename Rep, typename Period, typename FirstRep, typename FirstPeriod>
+        timer_id transmit_signal_every(packed_signal<signal_table> call, std::chrono::duration<Rep, Period> period,
+                                       std::chrono::duration<FirstRep, FirstPeriod> first_delay)
+        {
+            time_point deadline = _clock.now() + std::chrono::ceil<duration>(first_delay);
+            std::uint64_t period_ticks = std::max<std::uint64_t>(1, ticks_of(std::chrono::ceil<duration>(period)));
+            if (call && !call.is_copyable())
+                call = packed_signal<signal_table>([shared = std::make_shared<packed_signal<signal_table>>(std::move(call))]
+                                                   (signal_table& table) { (*shared)(table); });
+
+            std::lock_guard<locker_type> lock(_locker);
+            return _wheel.schedule(ticks_until(deadline), period_ticks, std::move(call));
+        }
+
+        // Returns false if signal is already transmitted or cancelled
+        bool cancel(timer_id id)
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            return _wheel.cancel(id);
+        }
+
+        // Transmit all signals which deadline is reached and return their number
+        std::size_t poll()
+        {
+            // Expired signals are collected locally, since receiver could poll again or destroy
+            // this object while they are transmitted.
+            std::vector<packed_signal<signal_table>> expired;
+            {
+                std::lock_guard<locker_type> lock(_locker);
+                _wheel.advance(ticks_of(_clock.now() - _start),
+                               [&expired](auto&& call) { expired.push_back(std::forward<decltype(call)>(call)); });
+            } // ~lock_guard to release wheel while signals are transmitted
+
+            std::size_t count = 0;
+            for (auto& call : expired) {
+                ++count;
+                // Stop if receiver was destroyed by the signal
+                if (!this->send(std::move(call)))
+                    break;
+            }
+            return count;
+        }
+
+        // Number of scheduled signals
+        std::size_t size()
+        {
+            std::lock_guard<locker_type> lock(_locker);
+            return _wheel.size();
+        }
+
+    private:
+        std::uint64_t ticks_of(duration interval) const noexcept
+        {
+            return interval > duration::zero() ? static_cast<std::uint64_t>(interval / _resolution) : 0;
+        }
+
+        // Number of the first tick that is not before the deadline
+        std::uint64_t ticks_until(time_point deadline) const noexcept
+        {
+            duration interval = deadline - _start;
+            std::uint64_t ticks = ticks_of(interval);
+            return interval > _resolution * ticks ? ticks + 1 : ticks;
+        }
+
+        clock_type _clock;
+        const time_point _start;
+        const duration _resolution;
+        wheel_type _wheel;
+        locker_type _locker;
     };
 
 } // namespace mtl
@@ -19,6 +19,9 @@ License.
 
 #include "signal.hpp"
 
+#include <cstddef>
+#include <span>
+
 namespace mtl
 {
     // This file is to implement signal transmission feature. Please see signal.hpp for details.
@@ -40,4 +43,36 @@ namespace mtl
         receiver& operator=(const receiver& other) { return *this; }
         receiver& operator=(const receiver&& other) { return *this; }
     };
+
+    // Batch receiver gets queued signals by batches (see queue_proxy_receiver::pop_batch). The
+    // batch is split into runs of consecutive signals of one method, and each run is passed to
+    // receive_batch(). Receiver could override it to process the run at once, for example by
+    // one system call, and get signal arguments by packed_signal::visit(). The default
+    // implementation performs signals one by one. Override transmit_batch() to get the whole
+    // mixed batch.
+    template<typename signal_table>
+    class batch_receiver
+        : public receiver<signal_table>
+    {
+    public:
+        void transmit_batch(std::span<const packed_signal<signal_table>> calls) override
+        {
+            while (!calls.empty()) {
+                signal_id<signal_table> signal = calls.front().signal();
+                std::size_t count = 1;
+                while (signal && count < calls.size() && calls[count].signal() == signal)
+                    ++count;
+
+                receive_batch(calls.first(count));
+                calls = calls.subspan(count);
+            }
+        }
+
+    protected:
+        virtual void receive_batch(std::span<const packed_signal<signal_table>> calls)
+        {
+            for (const auto& call : calls)
+                call(*this);
+        }
+    };
 } // namespace mtl
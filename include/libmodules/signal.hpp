@@ -17,10 +17,25 @@ License.
 ***************************************************************************************************/
 #pragma once
 
-#include "spy_pointer.hpp"
+#include "linked_list.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
 #include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace mtl
 {
@@ -55,24 +70,495 @@ namespace mtl
         using std::logic_error::logic_error;
     };
 
+    // Packed signal with move-only arguments could not be copied
+    class signal_not_copyable
+        : public std::logic_error
+    {
+    public:
+        using std::logic_error::logic_error;
+    };
+
+    // Signal identifier is a type erased pointer to the signal method. It allows to compare
+    // signals of different signatures, for example to subscribe transmitter to the particular
+    // signals of the table. Empty identifier means that signal is unknown. Pointers to methods of
+    // one class have the same representation, so the pointer is copied bitwise.
     template<typename signal_table>
-    using packed_signal = std::function<void(signal_table&)>;
+    class signal_id
+    {
+        using generic_signal = void (signal_table::*)();
+
+    public:
+        signal_id() noexcept = default;
+
+        template<typename signal_type,
+                 typename = std::enable_if_t<std::is_member_function_pointer_v<signal_type>>>
+        signal_id(signal_type signal_name) noexcept
+            : _signal(std::bit_cast<generic_signal>(signal_name))
+        {}
+
+        explicit operator bool() const noexcept { return !!_signal; }
+
+        bool operator ==(const signal_id& other) const noexcept { return _signal == other._signal; }
+        bool operator !=(const signal_id& other) const noexcept { return _signal != other._signal; }
+
+        // Hash of the pointer representation to use identifier as the key of hash tables
+        std::size_t hash() const noexcept
+        {
+            auto bytes = std::bit_cast<std::array<char, sizeof(generic_signal)>>(_signal);
+            return std::hash<std::string_view>()(std::string_view(bytes.data(), bytes.size()));
+        }
+
+    private:
+        generic_signal _signal = nullptr;
+    };
+
+    // Signal traits describe parameters of the signal method. Visitor is a function that gets
+    // signal arguments the same way as the signal method does. Arguments type is a tuple that
+    // could store the arguments by value.
+    template<typename signal_type>
+    struct signal_traits;
+
+    template<typename result_type, typename table_type, typename... Params>
+    struct signal_traits<result_type (table_type::*)(Params...)>
+    {
+        using visitor_type = void (*)(void* function, Params... params);
+        using arguments_type = std::tuple<std::decay_t<Params>...>;
+
+        template<typename function_type>
+        using invoke_result = std::invoke_result_t<function_type&, Params...>;
+
+        template<typename function_type>
+        static void visit(void* function, Params... params)
+        {
+            (*static_cast<function_type*>(function))(std::forward<Params>(params)...);
+        }
+    };
+
+    template<typename result_type, typename table_type, typename... Params>
+    struct signal_traits<result_type (table_type::*)(Params...) const>
+        : signal_traits<result_type (table_type::*)(Params...)> {};
+
+    template<typename result_type, typename table_type, typename... Params>
+    struct signal_traits<result_type (table_type::*)(Params...) noexcept>
+        : signal_traits<result_type (table_type::*)(Params...)> {};
+
+    template<typename result_type, typename table_type, typename... Params>
+    struct signal_traits<result_type (table_type::*)(Params...) const noexcept>
+        : signal_traits<result_type (table_type::*)(Params...)> {};
+
+    // Size of the buffer that packed signal uses to store signal arguments without memory
+    // allocation. It could be specialized for the signal table that transmits larger arguments.
+    // The default value fits whole packed signal object into one cache line.
+    template<typename signal_table>
+    inline constexpr std::size_t packed_signal_buffer_size = 64 - sizeof(void*);
+
+    // Packed signal is a callable object that stores signal method and its arguments and performs
+    // the signal on the provided signal table later. It is close to std::function<void(signal_table&)>
+    // but stores the callable object inline in the fixed size buffer. The heap is used only in
+    // case if callable object does not fit into the buffer.
+    //
+    // Packed signal could be constructed by signal method and arguments:
+    //   packed_signal<signal_table>(&signal_table::signal_name, args...);
+    // or by any callable object that accepts reference to signal table:
+    //   packed_signal<signal_table>(std::bind(&signal_table::signal_name, std::placeholders::_1, args...));
+    //
+    // Arguments are stored by value. Use std::ref to pack reference to the argument like
+    // std::bind does.
+    //
+    // Callable object and arguments could be move-only. Such packed signal could be moved but
+    // copying throws signal_not_copyable. Arguments that signal method can't get as lvalues, like
+    // std::unique_ptr passed by value, are moved to the receiver, so the signal is performed once.
+    //
+    // Packed signal knows identifier of the signal method it was constructed from. Callable object
+    // could provide it by `signal_id<signal_table> signal() const` method. Arguments of the signal
+    // packed by signal method could be inspected by visit().
+    template<typename signal_table, std::size_t buffer_size = packed_signal_buffer_size<signal_table>>
+    class packed_signal
+    {
+        // Signal method with arguments bound to it
+        template<typename signal_type, typename... Args>
+        struct bound_signal
+        {
+            // Arguments are moved into the method that can't take lvalues, so it is invoked once
+            static constexpr bool moves_arguments = !std::is_invocable_v<signal_type, signal_table&, Args&...>;
+
+            signal_type _signal;
+            std::tuple<Args...> _args;
+            [[no_unique_address]] std::conditional_t<moves_arguments, bool, std::tuple<>> _is_invoked{};
+
+            void operator()(signal_table& table)
+            {
+                if constexpr (!moves_arguments) {
+                    std::apply([&](Args&... args) { (table.*_signal)(args...); }, _args);
+                }
+                else {
+                    if (std::exchange(_is_invoked, true))
+                        throw signal_not_copyable("Unable to invoke signal with moved out arguments.");
+                    std::apply([&](Args&... args) { (table.*_signal)(std::move(args)...); }, _args);
+                }
+            }
+
+            signal_id<signal_table> signal() const noexcept { return _signal; }
+
+            // Arguments are moved out to the visitor if signal is consumed
+            bool visit(void (*visitor)(), void* function, bool is_consumed)
+            {
+                using visitor_type = typename signal_traits<signal_type>::visitor_type;
+                auto typed_visitor = reinterpret_cast<visitor_type>(visitor);
+                if constexpr (std::is_invocable_v<visitor_type, void*, Args&&...>) {
+                    if (is_consumed) {
+                        std::apply([&](Args&... args) { typed_visitor(function, std::move(args)...); }, _args);
+                        return true;
+                    }
+                }
+                if constexpr (std::is_invocable_v<visitor_type, void*, Args&...>) {
+                    std::apply([&](Args&... args) { typed_visitor(function, args...); }, _args);
+                    return true;
+                }
+                else {
+                    return false;
+                }
+            }
+        };
+
+        // Operations over the stored callable object. Each stored type has its own static table.
+        struct operations
+        {
+            void (*invoke)(void* storage, signal_table& table);
+            // Copy is null if callable object is move-only
+            void (*copy)(void* to, const void* from);
+            void (*move)(void* to, void* from) noexcept;
+            void (*destroy)(void* storage) noexcept;
+            signal_id<signal_table> (*signal)(const void* storage) noexcept;
+            bool (*visit)(void* storage, void (*visitor)(), void* function, bool is_consumed);
+            bool is_inline;
+        };
+
+        template<typename callable_type>
+        static constexpr bool is_stored_inline = sizeof(callable_type) <= buffer_size
+                                              && alignof(callable_type) <= alignof(std::max_align_t)
+                                              && std::is_nothrow_move_constructible_v<callable_type>;
+
+        template<typename callable_type>
+        static callable_type* target(void* storage) noexcept
+        {
+            if constexpr (is_stored_inline<callable_type>)
+                return std::launder(static_cast<callable_type*>(storage));
+            else
+                return *static_cast<callable_type**>(storage);
+        }
+
+        template<typename callable_type>
+        static constexpr operations operations_for =
+        {
+            [](void* storage, signal_table& table) { (*target<callable_type>(storage))(table); },
+            []() -> void (*)(void*, const void*) {
+                if constexpr (std::is_copy_constructible_v<callable_type>)
+                    return [](void* to, const void* from) {
+                        const callable_type& other = *target<callable_type>(const_cast<void*>(from));
+                        if constexpr (is_stored_inline<callable_type>)
+                            ::new (to) callable_type(other);
+                        else
+                            *static_cast<callable_type**>(to) = new callable_type(other);
+                    };
+                else
+                    return nullptr;
+            }(),
+            [](void* to, void* from) noexcept {
+                if constexpr (is_stored_inline<callable_type>) {
+                    ::new (to) callable_type(std::move(*target<callable_type>(from)));
+                    target<callable_type>(from)->~callable_type();
+                }
+                else
+                    *static_cast<callable_type**>(to) = target<callable_type>(from);
+            },
+            [](void* storage) noexcept {
+                if constexpr (is_stored_inline<callable_type>)
+                    target<callable_type>(storage)->~callable_type();
+                else
+                    delete target<callable_type>(storage);
+            },
+            [](const void* storage) noexcept {
+                const callable_type& call = *target<callable_type>(const_cast<void*>(storage));
+                if constexpr (requires { { call.signal() } -> std::convertible_to<signal_id<signal_table>>; })
+                    return signal_id<signal_table>(call.signal());
+                else
+                    return signal_id<signal_table>();
+            },
+            [](void* storage, void (*visitor)(), void* function, bool is_consumed) {
+                callable_type& call = *target<callable_type>(storage);
+                if constexpr (requires { { call.visit(visitor, function, is_consumed) } -> std::convertible_to<bool>; })
+                    return call.visit(visitor, function, is_consumed);
+                else
+                    return false;
+            },
+            is_stored_inline<callable_type>,
+        };
+
+        template<typename callable_type>
+        void emplace(callable_type&& call)
+        {
+            using stored_type = std::decay_t<callable_type>;
+            if constexpr (is_stored_inline<stored_type>)
+                ::new (static_cast<void*>(_buffer)) stored_type(std::forward<callable_type>(call));
+            else
+                *reinterpret_cast<stored_type**>(_buffer) = new stored_type(std::forward<callable_type>(call));
+            _operations = &operations_for<stored_type>;
+        }
+
+    public:
+        packed_signal() noexcept = default;
+        packed_signal(std::nullptr_t) noexcept {}
+
+        // Pack signal method and its arguments
+        template<typename signal_type, typename... Args,
+                 typename = std::enable_if_t<std::is_member_function_pointer_v<signal_type>>>
+        packed_signal(signal_type signal_name, Args&&... args)
+        {
+            emplace(bound_signal<signal_type, std::decay_t<Args>...>{signal_name, {std::forward<Args>(args)...}});
+        }
+
+        // Pack any callable object that could be performed on signal table
+        template<typename callable_type,
+                 typename = std::enable_if_t<!std::is_same_v<std::decay_t<callable_type>, packed_signal>
+                                          && !std::is_member_function_pointer_v<std::decay_t<callable_type>>
+                                          && std::is_invocable_v<std::decay_t<callable_type>&, signal_table&>>>
+        packed_signal(callable_type&& call)
+        {
+            emplace(std::forward<callable_type>(call));
+        }
+
+        packed_signal(const packed_signal& other)
+        {
+            if (!other._operations)
+                return;
+            if (!other._operations->copy)
+                throw signal_not_copyable("Unable to copy packed signal with move-only arguments.");
+            other._operations->copy(_buffer, other._buffer);
+            _operations = other._operations;
+        }
+
+        packed_signal(packed_signal&& other) noexcept
+        {
+            if (!other._operations)
+                return;
+            other._operations->move(_buffer, other._buffer);
+            _operations = std::exchange(other._operations, nullptr);
+        }
+
+        ~packed_signal() noexcept { reset(); }
+
+        packed_signal& operator =(const packed_signal& other)     { packed_signal tmp(other); return *this = std::move(tmp); }
+        packed_signal& operator =(packed_signal&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+            reset();
+            if (other._operations) {
+                other._operations->move(_buffer, other._buffer);
+                _operations = std::exchange(other._operations, nullptr);
+            }
+            return *this;
+        }
+        packed_signal& operator =(std::nullptr_t) noexcept        { reset(); return *this; }
+
+        void swap(packed_signal& other) noexcept
+        {
+            packed_signal tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        // Release stored callable object
+        void reset() noexcept
+        {
+            if (!_operations)
+                return;
+            std::exchange(_operations, nullptr)->destroy(_buffer);
+        }
+
+        // Perform the signal on provided signal table
+        void operator ()(signal_table& table) const
+        {
+            if (!_operations)
+                throw std::bad_function_call();
+            _operations->invoke(_buffer, table);
+        }
+
+        explicit operator bool() const noexcept { return !!_operations; }
+
+        // Identifier of packed signal method or empty identifier if it is unknown
+        signal_id<signal_table> signal() const noexcept
+        {
+            return _operations ? _operations->signal(_buffer) : signal_id<signal_table>();
+        }
+
+        // Call the function with packed arguments passed as the signal method gets them. Returns
+        // false if the signal is not packed by this signal method.
+        template<typename signal_type, typename function_type>
+        bool visit(signal_type signal_name, function_type&& function) const
+        {
+            return visit_arguments(signal_name, function, false);
+        }
+
+        // Call the function with packed arguments moved out of the signal, so move-only arguments
+        // could be taken. Signal keeps moved out arguments after that.
+        template<typename signal_type, typename function_type>
+        bool consume(signal_type signal_name, function_type&& function) &&
+        {
+            return visit_arguments(signal_name, function, true);
+        }
+
+        bool is_copyable() const noexcept { return !_operations || _operations->copy; }
+
+        // Check if the signal is stored in the inline buffer without heap allocation
+        bool is_inline() const noexcept { return !_operations || _operations->is_inline; }
+
+    private:
+        static_assert(buffer_size >= sizeof(void*), "Packed signal buffer should be able to store pointer to the heap.");
+
+        template<typename signal_type, typename function_type>
+        bool visit_arguments(signal_type signal_name, function_type& function, bool is_consumed) const
+        {
+            if (!_operations || signal() != signal_id<signal_table>(signal_name))
+                return false;
+
+            auto visitor = &signal_traits<signal_type>::template visit<function_type>;
+            return _operations->visit(_buffer, reinterpret_cast<void (*)()>(visitor),
+                                      const_cast<void*>(static_cast<const void*>(std::addressof(function))), is_consumed);
+        }
+
+        alignas(std::max_align_t) mutable unsigned char _buffer[buffer_size];
+        const operations* _operations = nullptr;
+    };
+
+    template<typename signal_table, std::size_t buffer_size>
+    void swap(packed_signal<signal_table, buffer_size>& first, packed_signal<signal_table, buffer_size>& second) noexcept
+    {
+        first.swap(second);
+    }
+
+    template<typename signal_table>
+    class transmitter;
+
+    template<typename signal_table>
+    class attachment;
+
+    template<typename signal_table>
+    class transmitter_list;
+
+    // Attachment owner is a container of attachments such as transmitter list. Transmitter asks
+    // the owner to release the attachment when it is detached from all emitters or destroyed.
+    template<typename signal_table>
+    class attachment_owner
+    {
+    public:
+        using transmitter_type = transmitter<signal_table>;
+        using attachment_type = attachment<signal_table>;
+
+    protected:
+        ~attachment_owner() = default;
+
+        // Unlink attachment from the transmitter and clear it
+        virtual void release(attachment_type& attachment) noexcept = 0;
+        // Release attachment of the transmitter that is being destroyed. Derived parts of the
+        // transmitter are already destroyed at this moment.
+        virtual void release_destroyed(attachment_type& attachment) noexcept { release(attachment); }
+
+        // Find the latest attachment of the transmitter that belongs to this owner
+        attachment_type* find(transmitter_type& transmitter) const noexcept;
+        static void reset(attachment_type& attachment) noexcept;
+
+    private:
+        friend class transmitter<signal_table>;
+    };
+
+    // Attachment is a record about one transmitter attached to one transmitter list or other
+    // owner. Attachments are stored by value in the dense array of the list and linked into the
+    // list of attachments of the transmitter at the same time. So, transmitter is able to release all its attachments
+    // at the destruction moment, and list is able to find attachment of the transmitter without
+    // search through the whole array. Attachment follows the linked list when it is moved inside
+    // the array.
+    //
+    // Released attachment stays in the array with empty transmitter until the list is compacted.
+    // This allows to release attachments while the list is iterated by index.
+    template<typename signal_table>
+    class attachment final
+        : private enable_linking_in_list<attachment<signal_table>>
+    {
+    public:
+        using base_type = enable_linking_in_list<attachment<signal_table>>;
+
+        attachment(transmitter<signal_table>& transmitter, attachment_owner<signal_table>& owner) noexcept
+            : base_type(transmitter._attachments)
+            , _transmitter(&transmitter)
+            , _receiver(transmitter.get())
+            , _owner(&owner)
+        {}
+
+        attachment(attachment&& other) noexcept
+            : base_type(std::move(other))
+            , _transmitter(std::exchange(other._transmitter, nullptr))
+            , _receiver(std::exchange(other._receiver, nullptr))
+            , _owner(other._owner)
+        {}
+
+        attachment& operator =(attachment&& other) noexcept
+        {
+            base_type::operator =(std::move(other));
+            _transmitter = std::exchange(other._transmitter, nullptr);
+            _receiver = std::exchange(other._receiver, nullptr);
+            _owner = other._owner;
+            return *this;
+        }
+
+        attachment(const attachment&) = delete;
+        attachment& operator =(const attachment&) = delete;
+
+        // Attached transmitter or nullptr if attachment was released
+        transmitter<signal_table>* get() const noexcept { return _transmitter; }
+        // Receiver of attached transmitter cached to avoid transmitter access while sending
+        signal_table* receiver() const noexcept { return _receiver; }
+
+        explicit operator bool() const noexcept { return !!_transmitter; }
+
+    private:
+        friend base_type;
+        friend class transmitter<signal_table>;
+        friend class attachment_owner<signal_table>;
+        friend class transmitter_list<signal_table>;
+
+        transmitter<signal_table>* _transmitter = nullptr;
+        signal_table* _receiver = nullptr;
+        attachment_owner<signal_table>* _owner = nullptr;
+    }; // class attachment
 
     template<typename signal_table>
     class transmitter
-        : private enable_spying<transmitter<signal_table>>
     {
     public:
         transmitter(signal_table* receiver = nullptr) : _receiver(receiver) {}
 
+        // Copy and move operations do not take attachments of other transmitter, but detach
+        // other transmitter in case if it was moved.
+        transmitter(const transmitter& other) noexcept : _receiver(other._receiver) {}
+        transmitter(transmitter&& other) noexcept : _receiver(other._receiver) { other.reset(); }
+
+        transmitter& operator =(const transmitter& other) noexcept { _receiver = other._receiver; return *this; }
+        transmitter& operator =(transmitter&& other) noexcept { _receiver = other._receiver; other.reset(); return *this; }
+
         // Returns receiver's interface
         // If no receiver specified then packed signal will be transmitted
         signal_table* get() const noexcept { return _receiver; }
 
         // Detach from all emitters
-        void reset() noexcept { base::clear(); }
+        void reset() noexcept
+        {
+            while (_attachments)
+                _attachments->_owner->release(*_attachments);
+        }
         // Check if it is attached to any emitter
-        bool empty() const noexcept { return base::empty(); }
+        bool empty() const noexcept { return !_attachments; }
 
         // Unpack packed signal and transmit it to the receiver
         // This method could be overridden to specify transmission
@@ -84,14 +570,181 @@ namespace mtl
             call(*_receiver);
         }
 
+        // Transmit the signal that is not used by the caller anymore. Transmitters that store
+        // signals override it to move the signal instead of copying.
+        virtual void transmit_signal(packed_signal<signal_table>&& call)
+        {
+            transmit_signal(static_cast<const packed_signal<signal_table>&>(call));
+        }
+
+        // Transmit the batch of signals in their order. Transmitter could override it to process
+        // the batch at once. The default implementation transmits signals one by one.
+        virtual void transmit_batch(std::span<const packed_signal<signal_table>> calls)
+        {
+            for (const auto& call : calls)
+                transmit_signal(call);
+        }
+
     protected:
-        ~transmitter() = default;
+        ~transmitter() noexcept
+        {
+            while (_attachments)
+                _attachments->_owner->release_destroyed(*_attachments);
+        }
 
     private:
-        using base = enable_spying<transmitter<signal_table>>;
+        friend class attachment<signal_table>;
+        friend class attachment_owner<signal_table>;
 
         signal_table* _receiver = nullptr;
+        // Head of the linked list of attachments to the emitters
+        attachment<signal_table>* _attachments = nullptr;
+    };
+
+    template<typename signal_table>
+    attachment<signal_table>* attachment_owner<signal_table>::find(transmitter_type& transmitter) const noexcept
+    {
+        for (attachment_type* attachment = transmitter._attachments; attachment; attachment = attachment->next())
+            if (attachment->_owner == this)
+                return attachment;
+        return nullptr;
+    }
+
+    template<typename signal_table>
+    void attachment_owner<signal_table>::reset(attachment_type& attachment) noexcept
+    {
+        attachment.unlink();
+        attachment._transmitter = nullptr;
+        attachment._receiver = nullptr;
+    }
+
+    // Transmitter list is the registry of transmitters attached to the emitter. Attachments are
+    // stored in the dense array in attachment order to iterate them in cache friendly way.
+    //
+    // Attach is an amortized O(1) operation. Detach and release take O(1) time regarding the list
+    // size. Detach just walks through the attachments of the transmitter to find the record that
+    // belongs to the list. Released attachments keep their places in the array, so the list could
+    // be iterated by index while transmitters are detached. The array is compacted by explicit
+    // compact() call when nobody iterates it.
+    //
+    // Transmitters attached while iteration is in progress are placed after the end index
+    // captured at the beginning of the iteration. Release lock serializes releases of attachments
+    // made by other threads while the list is shared between them, see emitter::send_parallel().
+    template<typename signal_table>
+    class transmitter_list
+        : public attachment_owner<signal_table>
+    {
+    public:
+        using typename attachment_owner<signal_table>::transmitter_type;
+        using typename attachment_owner<signal_table>::attachment_type;
+
+        transmitter_list() noexcept = default;
+        ~transmitter_list() noexcept { clear(); }
+
+        // Copy attaches all transmitters of the other list once again
+        transmitter_list(const transmitter_list& other) { *this = other; }
+        transmitter_list(transmitter_list&& other) noexcept { *this = std::move(other); }
+
+        transmitter_list& operator =(const transmitter_list& other)
+        {
+            if (this == &other)
+                return *this;
+
+            clear();
+            _attachments.clear();
+            _attachments.reserve(other._size);
+            for (const attachment_type& attachment : other._attachments)
+                if (attachment)
+                    attach(*attachment.get());
+            return *this;
+        }
+
+        transmitter_list& operator =(transmitter_list&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            clear();
+            _attachments = std::move(other._attachments);
+            _size = std::exchange(other._size, 0);
+            _released = std::exchange(other._released, 0);
+            other._attachments.clear();
+            for (attachment_type& attachment : _attachments)
+                attachment._owner = this;
+            return *this;
+        }
 
-        friend class spy_pointer<transmitter<signal_table>>; // Provide access to parent
+        void attach(transmitter_type& transmitter)
+        {
+            _attachments.emplace_back(transmitter, *this);
+            ++_size;
+        }
+
+        // Release the latest attachment of the transmitter to this list.
+        // Returns false if transmitter is not attached.
+        bool detach(transmitter_type& transmitter) noexcept
+        {
+            attachment_type* attachment = this->find(transmitter);
+            if (!attachment)
+                return false;
+
+            release(*attachment);
+            return true;
+        }
+
+        // Release all attachments
+        void clear() noexcept
+        {
+            for (attachment_type& attachment : _attachments)
+                if (attachment)
+                    release(attachment);
+        }
+
+        // Remove released attachments from the array. It shifts indexes of the rest attachments.
+        void compact() noexcept
+        {
+            if (!_released)
+                return;
+
+            _attachments.erase(std::remove_if(_attachments.begin(), _attachments.end(),
+                                              [](const attachment_type& attachment) { return !attachment; }),
+                               _attachments.end());
+            _released = 0;
+        }
+
+        // Number of attached transmitters
+        std::size_t size() const noexcept { return _size; }
+        bool empty() const noexcept { return !_size; }
+        // Number of released attachments that are still stored in the array
+        std::size_t released() const noexcept { return _released; }
+
+        // Index access to the array of attachments including released ones
+        std::size_t end_index() const noexcept { return _attachments.size(); }
+        const attachment_type& operator [](std::size_t index) const noexcept { return _attachments[index]; }
+
+        void set_release_lock(std::recursive_mutex* lock) noexcept { _release_lock.store(lock); }
+
+    private:
+        void release(attachment_type& attachment) noexcept override
+        {
+            std::unique_lock<std::recursive_mutex> lock;
+            if (auto* release_lock = _release_lock.load())
+                lock = std::unique_lock<std::recursive_mutex>(*release_lock);
+
+            this->reset(attachment);
+            --_size;
+            ++_released;
+        }
+
+        std::vector<attachment_type> _attachments;
+        std::atomic<std::recursive_mutex*> _release_lock{nullptr};
+        std::size_t _size = 0;
+        std::size_t _released = 0;
     };
 } // namespace mtl
+
+template<typename signal_table>
+struct std::hash<mtl::signal_id<signal_table>>
+{
+    std::size_t operator()(const mtl::signal_id<signal_table>& signal) const noexcept { return signal.hash(); }
+};
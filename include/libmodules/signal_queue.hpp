@@ -0,0 +1,637 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+#pragma once
+
+#include "signal.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mtl
+{
+    // This file contains queues of signals that are used by queue proxy receivers to pass
+    // signals between threads.
+
+    class signal_queue_overflow
+        : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    // Indexes modified by different threads are placed at different cache lines to avoid false
+    // sharing.
+    inline constexpr std::size_t cache_line_size = 64;
+
+    // Signal ring is the FIFO queue of packed signals for one thread. It is the ring buffer that
+    // grows twice when it is full and never shrinks, so steady queuing doesn't allocate memory.
+    template<typename signal_table>
+    class signal_ring
+    {
+    public:
+        signal_ring() noexcept = default;
+
+        void push(packed_signal<signal_table> call)
+        {
+            if (_size == _slots.size())
+                grow();
+            _slots[(_head + _size) & (_slots.size() - 1)] = std::move(call);
+            ++_size;
+        }
+
+        // Returns false if the ring is empty
+        bool pop(packed_signal<signal_table>& call) noexcept
+        {
+            if (!_size)
+                return false;
+
+            call = std::move(_slots[_head]);
+            _head = (_head + 1) & (_slots.size() - 1);
+            --_size;
+            return true;
+        }
+
+        std::size_t size() const noexcept { return _size; }
+        bool empty() const noexcept { return !_size; }
+
+    private:
+        void grow()
+        {
+            std::vector<packed_signal<signal_table>> slots(_slots.empty() ? 16 : _slots.size() * 2);
+            for (std::size_t index = 0; index < _size; ++index)
+                slots[index] = std::move(_slots[(_head + index) & (_slots.size() - 1)]);
+            _slots.swap(slots);
+            _head = 0;
+        }
+
+        std::vector<packed_signal<signal_table>> _slots;
+        std::size_t _head = 0;
+        std::size_t _size = 0;
+    };
+
+    // Signal list enumerates signal methods of the table, for example to generate typed queue.
+    template<auto... signals>
+    struct signal_list {};
+
+    template<typename signal_table, typename signal_list_type>
+    class typed_signal_queue;
+
+    // Typed signal queue is the FIFO queue of signals for one thread that stores arguments of the
+    // listed signal methods without type erasure. Each entry is the signal index and the tuple of
+    // arguments placed in the contiguous byte ring one after another. Pop dispatches the entry by
+    // the index through the switch, so popped signal doesn't need indirect call and popping
+    // loop reads the memory sequentially. Ring grows twice when it is full and never shrinks.
+    //
+    //   Signals that are not listed and packed signals that don't provide arguments are stored as
+    // packed signals in the same ring, so the order of signals is kept.
+    template<typename signal_table, auto... signals>
+    class typed_signal_queue<signal_table, signal_list<signals...>>
+    {
+        static constexpr std::uint32_t signal_count = sizeof...(signals);
+        // Index of the entry with packed signal
+        static constexpr std::uint32_t packed_index = signal_count;
+        // Index of the padding at the end of the ring, next entry is placed at the beginning
+        static constexpr std::uint32_t wrap_index = signal_count + 1;
+
+        static constexpr std::size_t alignment = alignof(std::max_align_t);
+
+        template<std::uint32_t index>
+        static constexpr auto signal_at = std::get<index>(std::tuple<decltype(signals)...>(signals...));
+
+        template<std::uint32_t index>
+        using signal_type = std::remove_const_t<decltype(signal_at<index>)>;
+
+        template<std::uint32_t index>
+        struct payload
+        {
+            using type = typename signal_traits<signal_type<index>>::arguments_type;
+        };
+
+        template<std::uint32_t index>
+            requires (index == packed_index)
+        struct payload<index>
+        {
+            using type = packed_signal<signal_table>;
+        };
+
+        template<std::uint32_t index>
+        using payload_type = typename payload<index>::type;
+
+        struct header
+        {
+            std::uint32_t index;
+            std::uint32_t size;
+        };
+
+        static constexpr std::size_t round_up(std::size_t size) noexcept { return (size + alignment - 1) & ~(alignment - 1); }
+
+        static constexpr std::size_t header_size = round_up(sizeof(header));
+
+        template<std::uint32_t index>
+        static constexpr std::size_t entry_size = header_size + round_up(sizeof(payload_type<index>));
+
+        // Call the function template instantiated by the runtime index
+        template<typename function_type>
+        static void dispatch(std::uint32_t index, function_type&& function)
+        {
+            [&]<std::uint32_t... indexes>(std::integer_sequence<std::uint32_t, indexes...>) {
+                ((index == indexes ? (function.template operator()<indexes>(), true) : false) || ...);
+            }(std::make_integer_sequence<std::uint32_t, signal_count + 1>());
+        }
+
+        template<std::uint32_t index, typename FnType>
+        static constexpr bool is_signal(FnType signal_name) noexcept
+        {
+            if constexpr (std::is_same_v<signal_type<index>, FnType>)
+                return signal_at<index> == signal_name;
+            else
+                return false;
+        }
+
+        template<typename FnType>
+        static std::uint32_t index_of(FnType signal_name) noexcept
+        {
+            return [&]<std::uint32_t... indexes>(std::integer_sequence<std::uint32_t, indexes...>) {
+                std::uint32_t result = packed_index;
+                ((is_signal<indexes>(signal_name) ? (result = indexes, true) : false) || ...);
+                return result;
+            }(std::make_integer_sequence<std::uint32_t, signal_count>());
+        }
+
+        static std::uint32_t index_of(signal_id<signal_table> signal) noexcept
+        {
+            return [&]<std::uint32_t... indexes>(std::integer_sequence<std::uint32_t, indexes...>) {
+                std::uint32_t result = packed_index;
+                ((signal == signal_id<signal_table>(signal_at<indexes>) ? (result = indexes, true) : false) || ...);
+                return result;
+            }(std::make_integer_sequence<std::uint32_t, signal_count>());
+        }
+
+        static_assert(signal_count > 0, "Typed signal queue requires at least one signal method.");
+        static_assert(((alignof(typename signal_traits<decltype(signals)>::arguments_type) <= alignment) && ...),
+                      "Signal arguments should not be over-aligned.");
+
+    public:
+        typed_signal_queue() noexcept = default;
+        typed_signal_queue(typed_signal_queue&& other) noexcept { swap(other); }
+        typed_signal_queue& operator =(typed_signal_queue&& other) noexcept
+        {
+            typed_signal_queue tmp(std::move(other));
+            swap(tmp);
+            return *this;
+        }
+        ~typed_signal_queue() noexcept { clear(); }
+
+        void swap(typed_signal_queue& other) noexcept
+        {
+            std::swap(_buffer, other._buffer);
+            std::swap(_capacity, other._capacity);
+            std::swap(_head, other._head);
+            std::swap(_tail, other._tail);
+            std::swap(_used, other._used);
+            std::swap(_size, other._size);
+        }
+
+        // Push signal method with arguments. Arguments are converted to the parameter types of
+        // the signal method.
+        template<typename FnType, typename... Args,
+                 typename = std::enable_if_t<std::is_member_function_pointer_v<FnType>>>
+        void push(FnType signal_name, Args&&... args)
+        {
+            bool is_pushed = false;
+            dispatch(index_of(signal_name), [&]<std::uint32_t index>() {
+                if constexpr (index < signal_count) {
+                    if constexpr (std::is_constructible_v<payload_type<index>, Args&&...>) {
+                        emplace<index>(std::forward<Args>(args)...);
+                        is_pushed = true;
+                    }
+                }
+            });
+            if (!is_pushed)
+                emplace<packed_index>(signal_name, std::forward<Args>(args)...);
+        }
+
+        void push(packed_signal<signal_table> call)
+        {
+            bool is_pushed = false;
+            dispatch(index_of(call.signal()), [&]<std::uint32_t index>() {
+                if constexpr (index < signal_count)
+                    is_pushed = std::move(call).consume(signal_at<index>, [&](auto&&... args) {
+                        emplace<index>(std::forward<decltype(args)>(args)...);
+                    });
+            });
+            if (!is_pushed)
+                emplace<packed_index>(std::move(call));
+        }
+
+        // Pop the signal and call function with the signal method and arguments, or with the
+        // packed signal if it was stored packed. Arguments are moved out of the entry and passed
+        // as rvalues. Entry is released before the call, so function could push signals or
+        // destroy this queue. Returns false if the queue is empty.
+        template<typename function_type>
+        bool pop(function_type&& function)
+        {
+            if (!_size)
+                return false;
+
+            header* entry = header_at(_head);
+            if (entry->index == wrap_index) {
+                _used -= _capacity - _head;
+                _head = 0;
+                entry = header_at(0);
+            }
+
+            dispatch(entry->index, [&]<std::uint32_t index>() {
+                payload_type<index> arguments(std::move(*payload_at<index>(entry)));
+                release(entry);
+                if constexpr (index < signal_count)
+                    std::apply([&](auto&... args) { function(signal_at<index>, std::move(args)...); }, arguments);
+                else
+                    function(std::move(arguments));
+            });
+            return true;
+        }
+
+        void clear() noexcept
+        {
+            while (_size) {
+                header* entry = header_at(_head);
+                if (entry->index == wrap_index) {
+                    _used -= _capacity - _head;
+                    _head = 0;
+                    continue;
+                }
+                release(entry);
+            }
+        }
+
+        std::size_t size() const noexcept { return _size; }
+        bool empty() const noexcept { return !_size; }
+        // Number of bytes in the ring
+        std::size_t capacity() const noexcept { return _capacity; }
+
+    private:
+        header* header_at(std::size_t offset) const noexcept
+        {
+            return std::launder(reinterpret_cast<header*>(reinterpret_cast<unsigned char*>(_buffer.get()) + offset));
+        }
+
+        template<std::uint32_t index>
+        static payload_type<index>* payload_at(header* entry) noexcept
+        {
+            return std::launder(reinterpret_cast<payload_type<index>*>(reinterpret_cast<unsigned char*>(entry) + header_size));
+        }
+
+        template<std::uint32_t index, typename... Args>
+        void emplace(Args&&... args)
+        {
+            std::size_t offset = reserve(entry_size<index>);
+            unsigned char* place = reinterpret_cast<unsigned char*>(_buffer.get()) + offset;
+            ::new (static_cast<void*>(place + header_size)) payload_type<index>(std::forward<Args>(args)...);
+            ::new (static_cast<void*>(place)) header{index, static_cast<std::uint32_t>(entry_size<index>)};
+            _tail = offset + entry_size<index>;
+            if (_tail == _capacity)
+                _tail = 0;
+            _used += entry_size<index>;
+            ++_size;
+        }
+
+        // Destroy the entry at the head and advance the head
+        void release(header* entry) noexcept
+        {
+            dispatch(entry->index, [&]<std::uint32_t index>() { std::destroy_at(payload_at<index>(entry)); });
+            _head += entry->size;
+            _used -= entry->size;
+            if (_head == _capacity)
+                _head = 0;
+            if (!--_size)
+                _head = _tail = _used = 0;
+        }
+
+        // Find the contiguous space for the entry and return its offset. Unused space at the
+        // end of the ring is marked by the wrap entry.
+        std::size_t reserve(std::size_t size)
+        {
+            if (!_used && size <= _capacity)
+                return _tail;
+
+            if (_used < _capacity) {
+                if (_tail >= _head) {
+                    if (size <= _capacity - _tail)
+                        return _tail;
+                    if (size <= _head) {
+                        ::new (static_cast<void*>(header_at(_tail))) header{wrap_index, static_cast<std::uint32_t>(_capacity - _tail)};
+                        _used += _capacity - _tail;
+                        _tail = 0;
+                        return 0;
+                    }
+                }
+                else if (size <= _head - _tail) {
+                    return _tail;
+                }
+            }
+
+            grow(size);
+            return _tail;
+        }
+
+        // Move entries to the new ring in order
+        void grow(std::size_t size)
+        {
+            std::size_t capacity = std::max<std::size_t>(_capacity ? _capacity * 2 : 1024, round_up(_used + size));
+            typed_signal_queue next;
+            next._buffer = std::make_unique<std::max_align_t[]>(capacity / alignment);
+            next._capacity = capacity;
+            while (_size) {
+                header* entry = header_at(_head);
+                if (entry->index == wrap_index) {
+                    _used -= _capacity - _head;
+                    _head = 0;
+                    continue;
+                }
+                dispatch(entry->index, [&]<std::uint32_t index>() { next.template emplace<index>(std::move(*payload_at<index>(entry))); });
+                release(entry);
+            }
+            swap(next);
+        }
+
+        std::unique_ptr<std::max_align_t[]> _buffer;
+        std::size_t _capacity = 0;
+        std::size_t _head = 0;
+        std::size_t _tail = 0;
+        // Bytes taken by entries and wrap padding
+        std::size_t _used = 0;
+        std::size_t _size = 0;
+    };
+
+    // Single producer single consumer queue is a bounded ring buffer of packed signals. Capacity
+    // is rounded up to the power of two. All slots are allocated by the constructor, so push and
+    // pop do not allocate memory unless signal arguments do not fit the packed signal buffer.
+    //
+    // Only one thread could push signals and only one thread could pop them at the same time.
+    // Each side caches the last seen index of the other side, so it touches the shared cache line
+    // only when the queue seems to be full or empty.
+    template<typename signal_table>
+    class spsc_signal_queue
+    {
+    public:
+        explicit spsc_signal_queue(std::size_t capacity)
+            : _mask(round_up(capacity) - 1)
+            , _slots(std::make_unique<packed_signal<signal_table>[]>(_mask + 1))
+        {}
+
+        spsc_signal_queue(const spsc_signal_queue&) = delete;
+        spsc_signal_queue& operator =(const spsc_signal_queue&) = delete;
+
+        // Producer side. Returns false if the queue is full, rvalue signal is not moved then.
+        bool push(const packed_signal<signal_table>& call) { return push_signal(call); }
+        bool push(packed_signal<signal_table>&& call)      { return push_signal(std::move(call)); }
+
+        // Consumer side. Returns false if the queue is empty.
+        bool pop(packed_signal<signal_table>& call) noexcept
+        {
+            std::size_t head = _consumer.head.load(std::memory_order_relaxed);
+            if (head == _consumer.cached_tail) {
+                _consumer.cached_tail = _producer.tail.load(std::memory_order_acquire);
+                if (head == _consumer.cached_tail)
+                    return false;
+            }
+
+            call = std::move(_slots[head & _mask]);
+            _consumer.head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        std::size_t capacity() const noexcept { return _mask + 1; }
+        // Approximate number of queued signals if it is called while other threads work
+        std::size_t size() const noexcept
+        {
+            return _producer.tail.load(std::memory_order_acquire) - _consumer.head.load(std::memory_order_acquire);
+        }
+        bool empty() const noexcept { return !size(); }
+
+    private:
+        template<typename call_type>
+        bool push_signal(call_type&& call)
+        {
+            std::size_t tail = _producer.tail.load(std::memory_order_relaxed);
+            if (tail - _producer.cached_head > _mask) {
+                _producer.cached_head = _consumer.head.load(std::memory_order_acquire);
+                if (tail - _producer.cached_head > _mask)
+                    return false;
+            }
+
+            _slots[tail & _mask] = std::forward<call_type>(call);
+            _producer.tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        static std::size_t round_up(std::size_t capacity) noexcept
+        {
+            std::size_t result = 1;
+            while (result < capacity)
+                result <<= 1;
+            return result;
+        }
+
+        struct alignas(cache_line_size) producer_side
+        {
+            std::atomic<std::size_t> tail{0};
+            std::size_t cached_head = 0;
+        };
+
+        struct alignas(cache_line_size) consumer_side
+        {
+            std::atomic<std::size_t> head{0};
+            std::size_t cached_tail = 0;
+        };
+
+        const std::size_t _mask;
+        const std::unique_ptr<packed_signal<signal_table>[]> _slots;
+        producer_side _producer;
+        consumer_side _consumer;
+    };
+
+    // Node pool is the preallocated array of nodes with the lock-free free list. Any thread could
+    // allocate and release nodes, so node allocated by producer could be released by consumer
+    // without cross-thread malloc traffic. Free list head is tagged by the counter to avoid ABA
+    // problem. Node type should have std::atomic<std::uint32_t> next_free member.
+    template<typename node_type>
+    class node_pool
+    {
+    public:
+        explicit node_pool(std::size_t size)
+            : _size(static_cast<std::uint32_t>(std::min<std::size_t>(size, index_mask)))
+            , _nodes(_size ? std::make_unique<node_type[]>(_size) : nullptr)
+        {
+            for (std::uint32_t index = 0; index < _size; ++index)
+                _nodes[index].next_free.store(index + 1 < _size ? index + 2 : 0, std::memory_order_relaxed);
+            _free.store(_size ? 1 : 0, std::memory_order_relaxed);
+        }
+
+        node_pool(const node_pool&) = delete;
+        node_pool& operator =(const node_pool&) = delete;
+
+        // Returns nullptr if all nodes are allocated
+        node_type* allocate() noexcept
+        {
+            std::uint64_t head = _free.load(std::memory_order_acquire);
+            for (;;) {
+                // Indexes are stored incremented by one, zero is the end of the list
+                std::uint32_t index = static_cast<std::uint32_t>(head & index_mask);
+                if (!index)
+                    return nullptr;
+
+                std::uint64_t next = _nodes[index - 1].next_free.load(std::memory_order_relaxed);
+                if (_free.compare_exchange_weak(head, next_tag(head) | next, std::memory_order_acquire))
+                    return &_nodes[index - 1];
+            }
+        }
+
+        void release(node_type* node) noexcept
+        {
+            std::uint64_t index = static_cast<std::uint64_t>(node - _nodes.get()) + 1;
+            std::uint64_t head = _free.load(std::memory_order_relaxed);
+            do
+                node->next_free.store(static_cast<std::uint32_t>(head & index_mask), std::memory_order_relaxed);
+            while (!_free.compare_exchange_weak(head, next_tag(head) | index, std::memory_order_release,
+                                                std::memory_order_relaxed));
+        }
+
+        bool owns(const node_type* node) const noexcept
+        {
+            return _size && node >= _nodes.get() && node < _nodes.get() + _size;
+        }
+
+        std::size_t size() const noexcept { return _size; }
+
+    private:
+        static constexpr std::uint64_t index_mask = 0xffffffffu;
+
+        static std::uint64_t next_tag(std::uint64_t head) noexcept { return (head & ~index_mask) + (index_mask + 1); }
+
+        const std::uint32_t _size;
+        const std::unique_ptr<node_type[]> _nodes;
+        std::atomic<std::uint64_t> _free{0};
+    };
+
+    // Multiple producers single consumer queue is the unbounded intrusive queue of D. Vyukov.
+    // Producer allocates the node and links it by one atomic exchange, so producers never wait
+    // for each other. Consumer never waits too. It could see the queue empty for a moment while
+    // producer is between the exchange and the link, the signal is popped by the next call then.
+    // Signals of one producer are popped in the order they were pushed.
+    //
+    // Nodes are taken from the preallocated pool. Queue allocates nodes from the heap only when
+    // the pool is exhausted, so the queue that keeps less than preallocated number of signals
+    // does not call malloc. Signal arguments are stored in the node if they fit the packed
+    // signal buffer.
+    template<typename signal_table>
+    class mpsc_signal_queue
+    {
+        struct node
+        {
+            std::atomic<node*> next{nullptr};
+            packed_signal<signal_table> call;
+            std::atomic<std::uint32_t> next_free{0};
+        };
+
+    public:
+        explicit mpsc_signal_queue(std::size_t preallocated = 0)
+            : _pool(preallocated)
+            , _head(allocate())
+            , _tail(_head.load(std::memory_order_relaxed))
+        {}
+
+        ~mpsc_signal_queue() noexcept
+        {
+            while (node* next = _tail->next.load(std::memory_order_acquire)) {
+                release(_tail);
+                _tail = next;
+            }
+            release(_tail);
+        }
+
+        mpsc_signal_queue(const mpsc_signal_queue&) = delete;
+        mpsc_signal_queue& operator =(const mpsc_signal_queue&) = delete;
+
+        // Producer side. It could be called by any number of threads.
+        void push(packed_signal<signal_table> call)
+        {
+            node* item = allocate();
+            item->call = std::move(call);
+            node* previous = _head.exchange(item, std::memory_order_acq_rel);
+            previous->next.store(item, std::memory_order_release);
+        }
+
+        // Consumer side. Returns false if the queue is empty.
+        bool pop(packed_signal<signal_table>& call) noexcept
+        {
+            // Tail is the node that was popped last time. Its signal is already taken.
+            node* next = _tail->next.load(std::memory_order_acquire);
+            if (!next)
+                return false;
+
+            call = std::move(next->call);
+            release(_tail);
+            _tail = next;
+            return true;
+        }
+
+        // Consumer side. Signal that is being pushed right now is already counted, so pop() could
+        // fail for a moment while the queue is not empty. Waiting consumer relies on it to not miss
+        // the signal whose producer skipped notification.
+        bool empty() const noexcept { return _head.load(std::memory_order_acquire) == _tail; }
+
+        std::size_t preallocated() const noexcept { return _pool.size(); }
+
+    private:
+        node* allocate()
+        {
+            node* item = _pool.allocate();
+            if (!item)
+                return new node;
+
+            item->next.store(nullptr, std::memory_order_relaxed);
+            return item;
+        }
+
+        void release(node* item) noexcept
+        {
+            if (_pool.owns(item)) {
+                item->call.reset();
+                _pool.release(item);
+            }
+            else {
+                delete item;
+            }
+        }
+
+        node_pool<node> _pool;
+        alignas(cache_line_size) std::atomic<node*> _head;
+        alignas(cache_line_size) node* _tail;
+    };
+} // namespace mtl
@@ -0,0 +1,77 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+#pragma once
+
+#include "signal.hpp"
+
+#include <tuple>
+#include <type_traits>
+
+namespace mtl
+{
+    // This file is to implement signal transmission feature. Please see signal.hpp for details.
+    // This file contains Static Emitter template implementation that emit signals to receivers
+    // wired at compile time.
+    //
+    // Static emitter is an alternative to emitter for topologies known at build time. It uses the
+    // same signal table and the same send() syntax, but stores references to receivers of exact
+    // types in a tuple instead of a list of transmitters. So, signal is delivered by the unrolled
+    // sequence of calls to the known receivers. There is no vector, no spy pointers, no receiver
+    // checks and no packed signals on the sending path. The only indirection left is the virtual
+    // signal method itself, because it is called by pointer to the member of signal table.
+    //
+    // Receivers are not attached and detached at runtime. They have to live longer than the
+    // static emitter.
+
+    template<typename signal_table, typename... receiver_types>
+    class static_emitter
+    {
+        static_assert((std::is_base_of_v<signal_table, receiver_types> && ...),
+                      "Static emitter receivers should implement the signal table.");
+
+        std::tuple<receiver_types&...> _receivers;
+
+    public:
+        explicit static_emitter(receiver_types&... receivers) noexcept : _receivers(receivers...) {}
+
+        static constexpr std::size_t size() noexcept { return sizeof...(receiver_types); }
+        static constexpr bool empty() noexcept { return !size(); }
+
+        // Arguments are passed to each receiver as lvalues. So, the rvalue argument could not be
+        // moved out by the first receiver.
+        template<typename FnType, typename... Args>
+        bool send(FnType signal_name, Args&&... args)
+        {
+            std::apply([&](receiver_types&... receivers) {
+                ((receivers.*signal_name)(args...), ...);
+            }, _receivers);
+            return true;
+        }
+
+        bool send(const packed_signal<signal_table>& call)
+        {
+            if (!call)
+                return true;
+
+            std::apply([&](receiver_types&... receivers) {
+                (call(static_cast<signal_table&>(receivers)), ...);
+            }, _receivers);
+            return true;
+        }
+    };
+} // namespace mtl
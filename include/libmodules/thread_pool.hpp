@@ -0,0 +1,274 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mtl
+{
+    // This file contains executors that could be used to run signal processing in parallel.
+    //
+    // Executor is any object that provides bulk_execute(count, task) method. The method calls
+    // task(index) for each index in [0, count) range, possibly in parallel, and returns when all
+    // calls are finished. The first exception thrown by the task is rethrown by bulk_execute after
+    // all started calls are finished. The rest of indexes are not processed after exception.
+
+    // Sequential executor performs all tasks in the calling thread
+    struct sequential_executor
+    {
+        template<typename task_type>
+        void bulk_execute(std::size_t count, task_type&& task)
+        {
+            for (std::size_t index = 0; index < count; ++index)
+                task(index);
+        }
+    };
+
+    // Thread pool is a fixed set of worker threads with work stealing. Each worker has its own
+    // task deque. Worker takes tasks from the back of its own deque and steals tasks from the
+    // front of other deques when its own deque is empty. Tasks posted from the worker thread are
+    // placed into its own deque, tasks posted from other threads are distributed between workers
+    // in round robin order.
+    //
+    // Thread pool is an executor. Its bulk_execute spreads indexes between workers dynamically, so
+    // fast workers take more indexes than slow ones. The calling thread takes part in the
+    // execution too.
+    class thread_pool
+    {
+    public:
+        using task_type = std::function<void()>;
+
+        explicit thread_pool(std::size_t thread_count = std::thread::hardware_concurrency())
+            : _queues(std::max<std::size_t>(thread_count, 1))
+        {
+            _threads.reserve(_queues.size());
+            for (std::size_t index = 0; index < _queues.size(); ++index)
+                _threads.emplace_back([this, index] { run(index); });
+        }
+
+        // Destructor finishes all posted tasks and joins worker threads
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+            }
+            _wakeup.notify_all();
+            for (auto& thread : _threads)
+                thread.join();
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator =(const thread_pool&) = delete;
+
+        std::size_t size() const noexcept { return _threads.size(); }
+
+        void post(task_type task) { push(std::move(task), false); }
+
+        // Post the task that yields to the tasks already queued by this worker. It is placed at
+        // the front of the deque, so the worker takes it after the rest of own tasks.
+        void defer(task_type task) { push(std::move(task), true); }
+
+        // Run one pending task by the worker thread that waits for other tasks of this pool.
+        // Returns false if there is no pending task or the calling thread is not the worker.
+        bool run_pending()
+        {
+            std::size_t index = current_worker();
+            if (index == no_worker)
+                return false;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_pending)
+                    return false;
+                --_pending;
+            }
+
+            task_type task;
+            while (!take(index, task))
+                std::this_thread::yield();
+            task();
+            return true;
+        }
+
+        template<typename bulk_task_type>
+        void bulk_execute(std::size_t count, bulk_task_type&& task)
+        {
+            if (!count)
+                return;
+
+            // State is shared with helper tasks that could start after bulk_execute is finished.
+            // They find no indexes to process and exit without touching the task.
+            struct bulk_state
+            {
+                std::atomic<std::size_t> next{0};
+                std::atomic<std::size_t> finished{0};
+                std::size_t count = 0;
+                std::exception_ptr error;
+                std::mutex mutex;
+                std::condition_variable done;
+            };
+            auto state = std::make_shared<bulk_state>();
+            state->count = count;
+
+            auto process = [state, &task] {
+                std::size_t processed = 0;
+                for (std::size_t index = state->next++; index < state->count; index = state->next++) {
+                    try {
+                        task(index);
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        if (!state->error)
+                            state->error = std::current_exception();
+                        // Skip the rest of indexes
+                        std::size_t skipped = state->count - std::min(state->count, state->next.exchange(state->count));
+                        processed += skipped;
+                    }
+                    ++processed;
+                }
+                if (processed && state->finished.fetch_add(processed) + processed == state->count) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->done.notify_all();
+                }
+            };
+
+            std::size_t helpers = std::min(count, size() + 1) - 1;
+            for (std::size_t i = 0; i < helpers; ++i)
+                post(process);
+            process();
+
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->done.wait(lock, [&] { return state->finished == state->count; });
+            if (state->error)
+                std::rethrow_exception(state->error);
+        }
+
+    private:
+        static constexpr std::size_t no_worker = static_cast<std::size_t>(-1);
+
+        void push(task_type task, bool is_deferred)
+        {
+            std::size_t index = current_worker();
+            if (index == no_worker)
+                index = _next_queue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+
+            {
+                std::lock_guard<std::mutex> lock(_queues[index].mutex);
+                if (is_deferred)
+                    _queues[index].tasks.push_front(std::move(task));
+                else
+                    _queues[index].tasks.push_back(std::move(task));
+            }
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                ++_pending;
+            }
+            _wakeup.notify_one();
+        }
+
+        struct task_queue
+        {
+            std::mutex mutex;
+            std::deque<task_type> tasks;
+        };
+
+        // Index of the pool worker that runs in the current thread
+        std::size_t current_worker() const noexcept
+        {
+            return worker_pool() == this ? worker_index() : no_worker;
+        }
+
+        static const thread_pool*& worker_pool() noexcept
+        {
+            thread_local const thread_pool* pool = nullptr;
+            return pool;
+        }
+
+        static std::size_t& worker_index() noexcept
+        {
+            thread_local std::size_t index = no_worker;
+            return index;
+        }
+
+        bool take(std::size_t index, task_type& task)
+        {
+            // Own tasks are taken from the back to keep the latest data hot in cache
+            {
+                auto& own = _queues[index];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+            // Other tasks are stolen from the front
+            for (std::size_t shift = 1; shift < _queues.size(); ++shift) {
+                auto& other = _queues[(index + shift) % _queues.size()];
+                std::lock_guard<std::mutex> lock(other.mutex);
+                if (!other.tasks.empty()) {
+                    task = std::move(other.tasks.front());
+                    other.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run(std::size_t index)
+        {
+            worker_pool() = this;
+            worker_index() = index;
+
+            task_type task;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _wakeup.wait(lock, [this] { return _pending || _stopping; });
+                    if (!_pending)
+                        return;
+                    --_pending;
+                }
+                // Pending counter guarantees that there is a task for this worker in some queue
+                while (!take(index, task))
+                    std::this_thread::yield();
+                task();
+                task = nullptr;
+            }
+        }
+
+        std::vector<task_queue> _queues;
+        std::vector<std::thread> _threads;
+        std::atomic<std::size_t> _next_queue{0};
+
+        std::mutex _mutex;
+        std::condition_variable _wakeup;
+        std::size_t _pending = 0;
+        bool _stopping = false;
+    };
+} // namespace mtl
@@ -0,0 +1,137 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+#pragma once
+
+#include "emitter.hpp"
+#include "signal_queue.hpp"
+#include "wait_strategy.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace mtl
+{
+    // Threaded receiver is an active object. It queues transmitted signals and resends them to
+    // the attached transmitters from its own worker thread. So, attaching threaded receiver to any
+    // emitter moves signal processing to the worker thread.
+    //
+    //   Transmission just pushes the signal into the lock-free queue (see signal_queue.hpp) and
+    // notifies the worker, it doesn't wait for other producers. Idle worker sleeps by the wait
+    // strategy (see wait_strategy.hpp) instead of polling.
+    //
+    //   Signals transmitted before start() are queued and processed by the worker when it is
+    // started. stop() waits for the worker. By default the worker processes all signals queued
+    // before stop() first. Receiver could be restarted after stop. Destructor detaches receiver
+    // from the emitters and stops the worker with draining. Receiver should not be stopped or
+    // destroyed by the signal processed in its worker thread.
+    //
+    //   Attached transmitters are called by the worker thread, so they should be attached and
+    // detached when the worker is stopped or by the worker itself. Exception thrown by them in
+    // the worker thread terminates the program.
+    template<typename signal_table, typename wait_strategy_type = blocking_wait>
+    class threaded_receiver
+        : public transmitter<signal_table>
+        , public emitter<signal_table>
+    {
+    public:
+        // Queue nodes for the preallocated number of signals are allocated at once, see
+        // mpsc_signal_queue.
+        explicit threaded_receiver(std::size_t preallocated = 0) : _signals(preallocated) {}
+        ~threaded_receiver() noexcept
+        {
+            this->transmitter<signal_table>::reset();
+            stop();
+        }
+
+        threaded_receiver(const threaded_receiver&) = delete;
+        threaded_receiver& operator =(const threaded_receiver&) = delete;
+
+        virtual void transmit_signal(const packed_signal<signal_table>& call) { push(call); }
+        virtual void transmit_signal(packed_signal<signal_table>&& call)      { push(std::move(call)); }
+
+        void start()
+        {
+            if (_worker.joinable())
+                return;
+
+            _is_stopping.store(false);
+            _worker = std::thread([this] { run(); });
+        }
+
+        // Stop the worker. Queued signals are processed before it if drain is true, otherwise
+        // they are kept until the next start.
+        void stop(bool drain = true) noexcept
+        {
+            if (!_worker.joinable())
+                return;
+
+            _is_draining.store(drain);
+            _is_stopping.store(true);
+            _waiter.notify_all();
+            _worker.join();
+        }
+
+        bool running() const noexcept { return _worker.joinable(); }
+
+        wait_strategy_type& wait_strategy() noexcept { return _waiter; }
+
+    private:
+        void push(packed_signal<signal_table> call)
+        {
+            _signals.push(std::move(call));
+            // Only the first signal after the worker went idle notifies it
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!_is_notified.exchange(true))
+                _waiter.notify_one();
+        }
+
+        void run()
+        {
+            packed_signal<signal_table> call;
+            for (;;) {
+                if (_is_stopping.load() && !_is_draining.load())
+                    return;
+
+                if (_signals.pop(call)) {
+                    this->send(std::move(call));
+                    call.reset();
+                    continue;
+                }
+
+                if (_is_stopping.load())
+                    return;
+
+                // Reset notification before the last check of the queue, so signal pushed after
+                // the check notifies the waiter again. Queue is not empty while any push is in
+                // progress, so the worker doesn't wait for the signal that is being linked.
+                _is_notified.store(false);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                _waiter.wait_until([this] { return !_signals.empty() || _is_stopping.load(); },
+                                   wait_clock::time_point::max());
+            }
+        }
+
+        mpsc_signal_queue<signal_table> _signals;
+        wait_strategy_type _waiter;
+        std::atomic<bool> _is_notified{false};
+        std::atomic<bool> _is_stopping{false};
+        std::atomic<bool> _is_draining{true};
+        std::thread _worker;
+    };
+} // namespace mtl
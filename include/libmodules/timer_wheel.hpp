@@ -0,0 +1,262 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mtl
+{
+    // Timer wheel is the hierarchical timing wheel of G. Varghese and T. Lauck. Time is measured
+    // in ticks. Each level has 64 slots, slot of level L covers 64^L ticks. Timer is placed to the
+    // level that covers its delay, and it moves to the lower level when time reaches its slot.
+    // So schedule and cancel take constant time regardless of the number of timers. Advance
+    // skips ticks while lower levels are empty, so it takes time proportional to the number of
+    // non-empty slots passed plus time for due timers.
+    //
+    //   Timers are stored in the array and linked into slots by indexes, so the wheel could be
+    // copied and moved. Timer identifier contains index and generation of the record, so
+    // cancellation of the fired or cancelled timer is detected. Timers that expire at the same
+    // tick fire in the scheduling order.
+    template<typename value_type>
+    class timer_wheel
+    {
+    public:
+        // Zero is never used as identifier
+        using timer_id = std::uint64_t;
+
+        static constexpr std::size_t levels = 6;
+        static constexpr std::size_t slot_bits = 6;
+        static constexpr std::size_t slots = std::size_t(1) << slot_bits;
+
+        timer_wheel() { clear_slots(); }
+
+        // Current tick
+        std::uint64_t now() const noexcept { return _now; }
+        // Number of scheduled timers
+        std::size_t size() const noexcept { return _size; }
+        bool empty() const noexcept { return !_size; }
+
+        // Schedule timer that expires at the expiry tick. Timer that is already expired fires at
+        // the next tick. Timer with non-zero period is rescheduled each period after firing.
+        timer_id schedule(std::uint64_t expiry, std::uint64_t period, value_type value)
+        {
+            std::uint32_t index;
+            if (_free.empty()) {
+                index = static_cast<std::uint32_t>(_timers.size());
+                _timers.emplace_back();
+            }
+            else {
+                index = _free.back();
+                _free.pop_back();
+            }
+
+            timer& item = _timers[index];
+            item.expiry = std::max(expiry, _now + 1);
+            item.period = period;
+            item.sequence = _sequence++;
+            item.value = std::move(value);
+            item.is_active = true;
+            link(index);
+            ++_size;
+            return (static_cast<timer_id>(item.generation) << 32) | (index + 1);
+        }
+
+        // Returns false if timer is already fired or cancelled
+        bool cancel(timer_id id)
+        {
+            std::uint32_t index = static_cast<std::uint32_t>(id & 0xffffffffu) - 1;
+            if (index >= _timers.size())
+                return false;
+
+            timer& item = _timers[index];
+            if (!item.is_active || item.generation != static_cast<std::uint32_t>(id >> 32))
+                return false;
+
+            unlink(index);
+            release(index);
+            return true;
+        }
+
+        // Advance time to the tick and call on_expired(value) for each expired timer. Value of
+        // the periodic timer is passed as lvalue, the rest values are moved. Callback should not
+        // schedule or cancel timers of this wheel.
+        template<typename callback_type>
+        void advance(std::uint64_t tick, callback_type&& on_expired)
+        {
+            while (_now < tick) {
+                // Nothing could expire before the tick
+                if (!_size) {
+                    _now = tick;
+                    return;
+                }
+
+                // Nothing happens until the next slot of the lowest non-empty level
+                std::size_t level = 0;
+                while (!_counts[level])
+                    ++level;
+                if (level) {
+                    std::uint64_t boundary = (_now | ((std::uint64_t(1) << (slot_bits * level)) - 1)) + 1;
+                    _now = std::min(tick, boundary - 1);
+                    if (_now == tick)
+                        return;
+                }
+
+                ++_now;
+                cascade();
+                expire(on_expired);
+            }
+        }
+
+    private:
+        static constexpr std::uint32_t no_timer = 0xffffffffu;
+
+        struct timer
+        {
+            std::uint64_t expiry = 0;
+            std::uint64_t period = 0;
+            std::uint64_t sequence = 0;
+            value_type value{};
+            std::uint32_t generation = 1;
+            std::uint32_t prev = no_timer;
+            std::uint32_t next = no_timer;
+            std::uint32_t level = 0;
+            std::uint32_t slot = 0;
+            bool is_active = false;
+        };
+
+        void clear_slots() noexcept
+        {
+            for (auto& level : _slots)
+                std::fill(std::begin(level), std::end(level), no_timer);
+        }
+
+        // Returns index of the slot in the level
+        std::size_t slot_of(std::uint64_t expiry, std::size_t& level) const noexcept
+        {
+            std::uint64_t delay = expiry - _now;
+            level = 0;
+            while (level + 1 < levels && delay >= (std::uint64_t(1) << (slot_bits * (level + 1))))
+                ++level;
+            // Timers beyond the wheel range wait in the last slot of the top level and are
+            // placed again when it is cascaded.
+            if (delay >> (slot_bits * levels))
+                expiry = _now + (std::uint64_t(1) << (slot_bits * levels)) - 1;
+            return (expiry >> (slot_bits * level)) & (slots - 1);
+        }
+
+        void link(std::uint32_t index) noexcept
+        {
+            timer& item = _timers[index];
+            std::size_t level;
+            std::size_t slot = slot_of(item.expiry, level);
+            std::uint32_t& head = _slots[level][slot];
+            ++_counts[level];
+            item.level = static_cast<std::uint32_t>(level);
+            item.slot = static_cast<std::uint32_t>(slot);
+            item.prev = no_timer;
+            item.next = head;
+            if (head != no_timer)
+                _timers[head].prev = index;
+            head = index;
+        }
+
+        void unlink(std::uint32_t index) noexcept
+        {
+            timer& item = _timers[index];
+            if (item.prev != no_timer)
+                _timers[item.prev].next = item.next;
+            else
+                _slots[item.level][item.slot] = item.next;
+            if (item.next != no_timer)
+                _timers[item.next].prev = item.prev;
+            --_counts[item.level];
+        }
+
+        void release(std::uint32_t index)
+        {
+            timer& item = _timers[index];
+            item.is_active = false;
+            item.value = value_type();
+            ++item.generation;
+            _free.push_back(index);
+            --_size;
+        }
+
+        // Move timers of the slots reached by the current tick to the lower levels. Higher levels
+        // are cascaded first, since their timers could move to the slot cascaded next.
+        void cascade()
+        {
+            std::size_t level = 0;
+            while (level + 1 < levels && !(_now & ((std::uint64_t(1) << (slot_bits * (level + 1))) - 1)))
+                ++level;
+
+            for (; level > 0; --level) {
+                std::uint32_t& head = _slots[level][(_now >> (slot_bits * level)) & (slots - 1)];
+                std::uint32_t index = std::exchange(head, no_timer);
+                while (index != no_timer) {
+                    std::uint32_t next = _timers[index].next;
+                    --_counts[level];
+                    link(index);
+                    index = next;
+                }
+            }
+        }
+
+        template<typename callback_type>
+        void expire(callback_type& on_expired)
+        {
+            std::uint32_t& head = _slots[0][_now & (slots - 1)];
+            if (head == no_timer)
+                return;
+
+            _due.clear();
+            for (std::uint32_t index = std::exchange(head, no_timer); index != no_timer; index = _timers[index].next)
+                _due.push_back(index);
+            _counts[0] -= _due.size();
+            std::sort(_due.begin(), _due.end(), [this](std::uint32_t first, std::uint32_t second) {
+                return _timers[first].sequence < _timers[second].sequence;
+            });
+
+            for (std::uint32_t index : _due) {
+                timer& item = _timers[index];
+                if (item.period) {
+                    on_expired(item.value);
+                    item.expiry += item.period;
+                    link(index);
+                }
+                else {
+                    on_expired(std::move(item.value));
+                    release(index);
+                }
+            }
+        }
+
+        std::vector<timer> _timers;
+        std::vector<std::uint32_t> _free;
+        std::vector<std::uint32_t> _due;
+        std::uint32_t _slots[levels][slots];
+        std::size_t _counts[levels] = {};
+        std::uint64_t _now = 0;
+        std::uint64_t _sequence = 0;
+        std::size_t _size = 0;
+    };
+} // namespace mtl
@@ -0,0 +1,210 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstdint>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace mtl
+{
+    // Wait strategy is the policy that specifies how queue consumer waits for signals. Strategy
+    // provides the following methods:
+    //   wait_until(is_ready, deadline) - wait until is_ready() returns true or deadline is
+    //                                    reached, returns the last is_ready() result
+    //   notify_one(), notify_all()     - wake up waiting consumers after is_ready() is changed
+    //
+    // Strategies trade CPU time for wake up latency. Spinning strategies react immediately but
+    // burn the core, blocking ones sleep in the kernel. Notification of spinning strategies costs
+    // nothing, notification of blocking ones costs one memory fence if nobody waits.
+
+    using wait_clock = std::chrono::steady_clock;
+
+    // Busy spin without leaving the core
+    struct spin_wait
+    {
+        template<typename predicate_type>
+        bool wait_until(predicate_type is_ready, wait_clock::time_point deadline)
+        {
+            while (!is_ready())
+                if (wait_clock::now() >= deadline)
+                    return false;
+            return true;
+        }
+
+        void notify_one() noexcept {}
+        void notify_all() noexcept {}
+    };
+
+    // Spin for a while and then yield the core to other threads between checks
+    template<unsigned spin_count = 100>
+    struct basic_spin_yield_wait
+    {
+        template<typename predicate_type>
+        bool wait_until(predicate_type is_ready, wait_clock::time_point deadline)
+        {
+            for (unsigned spin = 0; !is_ready(); ++spin) {
+                if (wait_clock::now() >= deadline)
+                    return false;
+                if (spin >= spin_count)
+                    std::this_thread::yield();
+            }
+            return true;
+        }
+
+        void notify_one() noexcept {}
+        void notify_all() noexcept {}
+    };
+
+    using spin_yield_wait = basic_spin_yield_wait<>;
+
+    // Sleep on condition variable. It is futex based on Linux.
+    class blocking_wait
+    {
+    public:
+        blocking_wait() noexcept = default;
+        // Copy creates independent waiting state
+        blocking_wait(const blocking_wait&) noexcept {}
+        blocking_wait& operator =(const blocking_wait&) noexcept { return *this; }
+
+        template<typename predicate_type>
+        bool wait_until(predicate_type is_ready, wait_clock::time_point deadline)
+        {
+            if (is_ready())
+                return true;
+
+            waiter_guard waiter(_waiters);
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (deadline == wait_clock::time_point::max()) {
+                _condition.wait(lock, is_ready);
+                return true;
+            }
+            return _condition.wait_until(lock, deadline, is_ready);
+        }
+
+        void notify_one() noexcept
+        {
+            if (has_waiters()) {
+                // Empty critical section orders notification after the check of waiting thread
+                { std::lock_guard<std::mutex> lock(_mutex); }
+                _condition.notify_one();
+            }
+        }
+
+        void notify_all() noexcept
+        {
+            if (has_waiters()) {
+                { std::lock_guard<std::mutex> lock(_mutex); }
+                _condition.notify_all();
+            }
+        }
+
+    private:
+        struct waiter_guard
+        {
+            explicit waiter_guard(std::atomic<unsigned>& waiters) noexcept : waiters(waiters) { waiters.fetch_add(1); }
+            ~waiter_guard() noexcept { waiters.fetch_sub(1); }
+            std::atomic<unsigned>& waiters;
+        };
+
+        // Pairs with the increment of waiters counter that precedes is_ready() check
+        bool has_waiters() const noexcept
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return !!_waiters.load(std::memory_order_relaxed);
+        }
+
+        std::atomic<unsigned> _waiters{0};
+        std::mutex _mutex;
+        std::condition_variable _condition;
+    };
+
+#if defined(__linux__)
+    // Sleep on eventfd. Descriptor could be polled by the event loop together with other file
+    // descriptors, see native_handle().
+    class eventfd_wait
+    {
+    public:
+        eventfd_wait() : _descriptor(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+        {
+            if (_descriptor < 0)
+                throw std::system_error(errno, std::generic_category(), "Unable to create eventfd.");
+        }
+        // Copy creates independent waiting state
+        eventfd_wait(const eventfd_wait&) : eventfd_wait() {}
+        eventfd_wait& operator =(const eventfd_wait&) noexcept { return *this; }
+        ~eventfd_wait() noexcept { ::close(_descriptor); }
+
+        int native_handle() const noexcept { return _descriptor; }
+
+        template<typename predicate_type>
+        bool wait_until(predicate_type is_ready, wait_clock::time_point deadline)
+        {
+            if (is_ready())
+                return true;
+
+            _waiters.fetch_add(1);
+            bool result = false;
+            while (!(result = is_ready())) {
+                int timeout = -1;
+                if (deadline != wait_clock::time_point::max()) {
+                    auto now = wait_clock::now();
+                    if (now >= deadline)
+                        break;
+                    // Round up to avoid busy loop at the end of the timeout
+                    timeout = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count());
+                }
+
+                pollfd descriptor{_descriptor, POLLIN, 0};
+                if (::poll(&descriptor, 1, timeout) > 0) {
+                    std::uint64_t counter;
+                    [[maybe_unused]] auto size = ::read(_descriptor, &counter, sizeof(counter));
+                }
+            }
+            _waiters.fetch_sub(1);
+            return result;
+        }
+
+        void notify_one() noexcept { notify_all(); }
+
+        void notify_all() noexcept
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_waiters.load(std::memory_order_relaxed)) {
+                std::uint64_t counter = 1;
+                [[maybe_unused]] auto size = ::write(_descriptor, &counter, sizeof(counter));
+            }
+        }
+
+    private:
+        int _descriptor;
+        std::atomic<unsigned> _waiters{0};
+    };
+#endif
+} // namespace mtl
@@ -0,0 +1,191 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+
+#include <libmodules/concurrent_emitter.hpp>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+using namespace std;
+
+struct concurrent_receiver;
+
+struct concurrent_signals
+{
+    virtual ~concurrent_signals() {}
+
+    virtual void count() = 0;
+    virtual void attach(concurrent_emitter<concurrent_signals>* em, concurrent_receiver* r) = 0;
+    virtual void detach(concurrent_emitter<concurrent_signals>* em, concurrent_receiver* r) = 0;
+};
+
+struct concurrent_receiver
+    : public concurrent_signals
+    , public transmitter<concurrent_signals>
+{
+    concurrent_receiver(bool is_valid = true) : transmitter<concurrent_signals>(is_valid ? this : nullptr) {}
+
+    void count() override                                                                   { ++received; }
+    void attach(concurrent_emitter<concurrent_signals>* em, concurrent_receiver* r) override { ++received; if (r->empty()) em->attach(*r); }
+    void detach(concurrent_emitter<concurrent_signals>* em, concurrent_receiver* r) override { ++received; if (!r->empty()) em->detach(*r); }
+
+    atomic<size_t> received{0};
+};
+
+TEST(concurrent_emitting, can_attach_and_detach_receivers)
+{
+    concurrent_emitter<concurrent_signals> em;
+    concurrent_receiver first, second;
+
+    em.attach(first);
+    em.attach(second);
+    EXPECT_EQ(em.size(), 2U);
+    EXPECT_FALSE(first.empty());
+
+    em.send(&concurrent_signals::count);
+    EXPECT_EQ(first.received, 1U);
+    EXPECT_EQ(second.received, 1U);
+
+    em.detach(first);
+    EXPECT_TRUE(first.empty());
+    EXPECT_EQ(em.size(), 1U);
+    EXPECT_THROW(em.detach(first), transmitter_not_attached);
+
+    em.send(&concurrent_signals::count);
+    EXPECT_EQ(first.received, 1U);
+    EXPECT_EQ(second.received, 2U);
+
+    em.reset();
+    EXPECT_TRUE(em.empty());
+    EXPECT_TRUE(second.empty());
+}
+
+TEST(concurrent_emitting, receiver_can_detach_itself)
+{
+    concurrent_emitter<concurrent_signals> em;
+    {
+        concurrent_receiver r;
+        em.attach(r);
+        EXPECT_EQ(em.size(), 1U);
+        r.reset();
+    }
+    EXPECT_TRUE(em.empty());
+    em.send(&concurrent_signals::count);
+}
+
+TEST(concurrent_emitting_death_test, receiver_should_be_detached_before_destruction)
+{
+    concurrent_emitter<concurrent_signals> em;
+    EXPECT_DEBUG_DEATH({
+        concurrent_receiver r;
+        em.attach(r);
+    }, "detached");
+}
+
+TEST(concurrent_emitting, emitter_can_autodetach)
+{
+    concurrent_receiver r;
+    {
+        concurrent_emitter<concurrent_signals> em;
+        em.attach(r);
+    }
+    EXPECT_TRUE(r.empty());
+}
+
+TEST(concurrent_emitting, can_forward_signals)
+{
+    concurrent_emitter<concurrent_signals> em;
+    concurrent_receiver r;
+    concurrent_receiver forwarder(false);
+    emitter<concurrent_signals> proxy;
+    struct proxy_transmitter : transmitter<concurrent_signals>
+    {
+        emitter<concurrent_signals>* target;
+        void transmit_signal(const packed_signal<concurrent_signals>& call) override { target->send(call); }
+    } t;
+    t.target = &proxy;
+    proxy.attach(r);
+    em.attach(t);
+
+    em.send(&concurrent_signals::count);
+    em.send(packed_signal<concurrent_signals>(&concurrent_signals::count));
+    EXPECT_EQ(r.received, 2U);
+
+    em.attach(forwarder);
+    EXPECT_THROW(em.send(&concurrent_signals::count), invalid_transmitter);
+    em.reset();
+}
+
+TEST(concurrent_emitting, can_attach_and_detach_while_sending)
+{
+    concurrent_emitter<concurrent_signals> em;
+    concurrent_receiver first, second, third;
+    em.attach(first);
+    em.attach(second);
+
+    em.send(&concurrent_signals::attach, &em, &third);
+    EXPECT_EQ(em.size(), 3U);
+    EXPECT_EQ(third.received, 0U);
+
+    // The first receiver detaches the second one before it receives the signal
+    em.send(&concurrent_signals::detach, &em, &second);
+    EXPECT_EQ(first.received, 2U);
+    EXPECT_EQ(second.received, 1U);
+    EXPECT_EQ(third.received, 1U);
+    EXPECT_EQ(em.size(), 2U);
+    em.reset();
+}
+
+TEST(concurrent_emitting, can_send_while_other_threads_attach_and_detach)
+{
+    concurrent_emitter<concurrent_signals> em;
+    concurrent_receiver permanent;
+    em.attach(permanent);
+
+    atomic<bool> is_done{false};
+    vector<thread> writers;
+    for (int index = 0; index < 2; ++index)
+        writers.emplace_back([&] {
+            for (int iteration = 0; iteration < 200; ++iteration) {
+                auto r = make_unique<concurrent_receiver>();
+                em.attach(*r);
+                this_thread::yield();
+                if (iteration % 2)
+                    em.detach(*r);
+                else
+                    r->reset();
+            }
+        });
+    thread reader([&] {
+        while (!is_done)
+            em.send(&concurrent_signals::count);
+    });
+
+    for (auto& writer : writers)
+        writer.join();
+    is_done = true;
+    reader.join();
+
+    EXPECT_EQ(em.size(), 1U);
+    EXPECT_GT(permanent.received, 0U);
+    em.reset();
+}
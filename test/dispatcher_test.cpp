@@ -0,0 +1,167 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+
+#include <libmodules/concurrent_emitter.hpp>
+#include <libmodules/dispatcher.hpp>
+#include <libmodules/receiver.hpp>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+using namespace std;
+
+struct dispatched_signals
+{
+    virtual ~dispatched_signals() {}
+
+    virtual void put(int value) = 0;
+};
+
+struct dispatched_test_receiver
+    : public receiver<dispatched_signals>
+{
+    vector<int> values;
+    atomic<int> running{0};
+    atomic<bool> overlapped{false};
+
+    void put(int value) override
+    {
+        if (running.fetch_add(1))
+            overlapped = true;
+        values.push_back(value);
+        this_thread::yield();
+        running.fetch_sub(1);
+    }
+};
+
+void wait_idle(dispatcher& d)
+{
+    while (d.ready())
+        this_thread::yield();
+}
+
+TEST(dispatcher, runs_receivers_on_thread_pool)
+{
+    dispatcher d(2);
+    dispatched_test_receiver r;
+    dispatched_receiver<dispatched_signals> proxy(d);
+    proxy.attach(r);
+
+    EXPECT_FALSE(proxy.ready());
+    for (int value = 1; value <= 100; ++value)
+        proxy.transmit_signal(packed_signal<dispatched_signals>(&dispatched_signals::put, value));
+    wait_idle(d);
+
+    EXPECT_FALSE(proxy.ready());
+    ASSERT_EQ(100U, r.values.size());
+    for (int value = 1; value <= 100; ++value)
+        ASSERT_EQ(value, r.values[value - 1]);
+}
+
+TEST(dispatcher, does_not_run_receiver_concurrently_with_itself)
+{
+    const int receivers = 8;
+    dispatcher d(4);
+    vector<unique_ptr<dispatched_test_receiver>> targets;
+    vector<unique_ptr<dispatched_receiver<dispatched_signals>>> proxies;
+    concurrent_emitter<dispatched_signals> em;
+    for (int index = 0; index < receivers; ++index) {
+        targets.push_back(make_unique<dispatched_test_receiver>());
+        proxies.push_back(make_unique<dispatched_receiver<dispatched_signals>>(d, 4));
+        proxies.back()->attach(*targets.back());
+        em.attach(*proxies.back());
+    }
+
+    vector<thread> producers;
+    for (int producer = 0; producer < 2; ++producer)
+        producers.emplace_back([&] {
+            for (int value = 0; value < 200; ++value)
+                em.send(&dispatched_signals::put, value);
+        });
+    for (auto& producer : producers)
+        producer.join();
+    wait_idle(d);
+
+    for (auto& target : targets) {
+        EXPECT_FALSE(target->overlapped);
+        EXPECT_EQ(400U, target->values.size());
+    }
+}
+
+TEST(dispatcher, waits_for_receiver_task_at_destruction)
+{
+    dispatcher d(1);
+    dispatched_test_receiver r;
+    {
+        dispatched_receiver<dispatched_signals> proxy(d);
+        proxy.attach(r);
+        for (int value = 1; value <= 10; ++value)
+            proxy.transmit_signal(packed_signal<dispatched_signals>(&dispatched_signals::put, value));
+    }
+    EXPECT_EQ(10U, r.values.size());
+}
+
+TEST(dispatcher, can_destroy_receiver_by_dispatcher_thread)
+{
+    dispatcher d(1);
+    dispatched_test_receiver r;
+    atomic<bool> is_done{false};
+    d.pool().post([&] {
+        {
+            dispatched_receiver<dispatched_signals> proxy(d);
+            proxy.attach(r);
+            for (int value = 1; value <= 10; ++value)
+                proxy.transmit_signal(packed_signal<dispatched_signals>(&dispatched_signals::put, value));
+        }
+        is_done = true;
+    });
+    while (!is_done)
+        this_thread::yield();
+    EXPECT_EQ(10U, r.values.size());
+}
+
+TEST(dispatcher, can_destroy_receiver_while_other_thread_sends)
+{
+    dispatcher d(2);
+    dispatched_test_receiver r;
+    concurrent_emitter<dispatched_signals> em;
+
+    atomic<bool> is_done{false};
+    thread sender([&] {
+        while (!is_done) {
+            em.send(&dispatched_signals::put, 1);
+            this_thread::yield();
+        }
+    });
+
+    for (int iteration = 0; iteration < 50; ++iteration) {
+        dispatched_receiver<dispatched_signals> proxy(d);
+        proxy.attach(r);
+        em.attach(proxy);
+        this_thread::yield();
+        em.detach(proxy);
+    }
+    is_done = true;
+    sender.join();
+    wait_idle(d);
+    EXPECT_TRUE(em.empty());
+}
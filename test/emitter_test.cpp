@@ -17,15 +17,30 @@ License.
 ***************************************************************************************************/
 
 #include <libmodules/emitter.hpp>
+#include <libmodules/thread_pool.hpp>
 #include <gmock/gmock.h>
 
 #include <memory>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 using namespace mtl;
 using namespace std;
 
 struct test_receiver;
 
+struct copy_counter
+{
+    size_t* copies = nullptr;
+
+    copy_counter(size_t* copies) : copies(copies) {}
+    copy_counter(const copy_counter& other) : copies(other.copies) { ++*copies; }
+    copy_counter(copy_counter&& other) = default;
+};
+
 struct test_emitter_signals
 {
     virtual ~test_emitter_signals() {}
@@ -38,6 +53,9 @@ struct test_emitter_signals
     virtual void delete_obj(shared_ptr<void>& obj) = 0;
     virtual void throw_at(size_t& count_down) = 0;
     virtual void send_signal(emitter<test_emitter_signals>& em, packed_signal<test_emitter_signals> s) = 0;
+    virtual void take_text(string text) = 0;
+    virtual void count_copies(const copy_counter& counter) = 0;
+    virtual void take_data(unique_ptr<int> data) = 0;
 };
 
 struct test_receiver
@@ -60,6 +78,12 @@ struct test_receiver
     void throw_at(size_t& count_down) override                                { received = true; if (!--count_down) throw runtime_error("Something bad happened."); }
     void send_signal(emitter<test_emitter_signals>& em, packed_signal<test_emitter_signals> s) override 
                                                                               { em.send(s); }
+    void take_text(string t) override                                         { received = true; text = move(t); }
+    void count_copies(const copy_counter&) override                           { received = true; }
+    void take_data(unique_ptr<int> d) override                                { received = true; data = move(d); }
+
+    string text;
+    unique_ptr<int> data;
 };
 
 struct test_proxy
@@ -368,3 +392,476 @@ TEST(emitting, can_interrupt_recursive_sending_by_exception_throwing)
     EXPECT_TRUE(r1.received);
     EXPECT_FALSE(r2.received);
 }
+
+TEST(emitting, counts_attached_transmitters)
+{
+    emitter<test_emitter_signals> em;
+    test_receiver r1, r2;
+    EXPECT_EQ(0u, em.size());
+
+    em.attach(r1);
+    em.attach(r2);
+    em.attach(r2);
+    EXPECT_EQ(3u, em.size());
+
+    em.detach(r2);
+    EXPECT_EQ(2u, em.size());
+    EXPECT_FALSE(r2.empty());
+
+    {
+        test_receiver r3;
+        em.attach(r3);
+        EXPECT_EQ(3u, em.size());
+    }
+    EXPECT_EQ(2u, em.size());
+
+    r2.reset();
+    EXPECT_EQ(1u, em.size());
+}
+
+TEST(emitting, keeps_attachment_order_after_detach)
+{
+    emitter<test_emitter_signals> em;
+    vector<unique_ptr<test_receiver>> receivers;
+    for (size_t i = 0; i < 16; ++i) {
+        receivers.push_back(make_unique<test_receiver>());
+        em.attach(*receivers.back());
+    }
+    for (size_t i = 0; i < 16; i += 2)
+        em.detach(*receivers[i]);
+    EXPECT_EQ(8u, em.size());
+
+    size_t counter = 4;
+    EXPECT_THROW(em.send(&test_emitter_signals::throw_at, ref(counter)), runtime_error);
+    for (size_t i = 0; i < 16; ++i)
+        EXPECT_EQ(i % 2 && i < 8, receivers[i]->received);
+}
+
+TEST(emitting, knows_sending_state)
+{
+    emitter<test_emitter_signals> em;
+    test_receiver r;
+    bool was_sending = false;
+
+    em.attach(r);
+    EXPECT_FALSE(em.sending());
+    EXPECT_TRUE(em.send(packed_signal<test_emitter_signals>([&](test_emitter_signals&) { was_sending = em.sending(); })));
+    EXPECT_TRUE(was_sending);
+    EXPECT_FALSE(em.sending());
+}
+
+TEST(emitting, stops_sending_when_emitter_is_moved)
+{
+    emitter<test_emitter_signals> em1, em2;
+    test_receiver r1, r2;
+
+    em1.attach(r1);
+    em1.attach(r2);
+    EXPECT_FALSE(em1.send(packed_signal<test_emitter_signals>([&](test_emitter_signals& table) { table.received = true; em2 = move(em1); })));
+    EXPECT_TRUE(r1.received);
+    EXPECT_FALSE(r2.received);
+    EXPECT_FALSE(em1.sending());
+    EXPECT_EQ(2u, em2.size());
+}
+
+TEST(emitting, does_not_send_moved_out_arguments)
+{
+    emitter<test_emitter_signals> em;
+    test_receiver r1, r2;
+    test_proxy p1, p2;
+
+    em.attach(r1);
+    em.attach(p1);
+    em.attach(r2);
+    em.attach(p2);
+    EXPECT_TRUE(em.send(&test_emitter_signals::take_text, string("text")));
+    EXPECT_EQ("text", r1.text);
+    EXPECT_EQ("text", r2.text);
+    EXPECT_EQ("text", p1._receiver.text);
+    EXPECT_EQ("text", p2._receiver.text);
+}
+
+TEST(emitting, sends_move_only_arguments_to_single_transmitter)
+{
+    emitter<test_emitter_signals> em;
+    test_receiver r1, r2;
+    test_proxy p;
+
+    em.attach(r1);
+    EXPECT_TRUE(em.send(&test_emitter_signals::take_data, make_unique<int>(1)));
+    ASSERT_TRUE(r1.data);
+    EXPECT_EQ(1, *r1.data);
+
+    em.attach(r2);
+    EXPECT_THROW(em.send(&test_emitter_signals::take_data, make_unique<int>(2)), signal_not_copyable);
+    EXPECT_EQ(1, *r1.data);
+    EXPECT_FALSE(r2.received);
+
+    em.detach(r1);
+    em.detach(r2);
+    em.attach(p);
+    EXPECT_TRUE(em.send(&test_emitter_signals::take_data, make_unique<int>(3)));
+    ASSERT_TRUE(p._receiver.data);
+    EXPECT_EQ(3, *p._receiver.data);
+
+    em.attach(r1);
+    EXPECT_THROW(em.send(&test_emitter_signals::take_data, make_unique<int>(4)), signal_not_copyable);
+    EXPECT_EQ(3, *p._receiver.data);
+}
+
+TEST(emitting, can_share_arguments_between_transmitters)
+{
+    emitter<test_emitter_signals> em;
+    test_receiver r1, r2;
+    test_proxy p1, p2;
+    size_t copies = 0;
+
+    em.attach(r1);
+    em.attach(p1);
+    em.attach(r2);
+    em.attach(p2);
+    EXPECT_TRUE(em.send_shared(&test_emitter_signals::count_copies, copy_counter(&copies)));
+    EXPECT_TRUE(r1.received);
+    EXPECT_TRUE(r2.received);
+    EXPECT_TRUE(p1._receiver.received);
+    EXPECT_TRUE(p2._receiver.received);
+    EXPECT_EQ(0u, copies);
+
+    EXPECT_TRUE(em.send_shared(&test_emitter_signals::take_text, string("text")));
+    EXPECT_EQ("text", r1.text);
+    EXPECT_EQ("text", p2._receiver.text);
+}
+
+TEST(emitting, can_delete_emitter_while_shared_sending)
+{
+    auto em = make_shared<emitter<test_emitter_signals>>();
+    auto* em_ptr = em.get();
+    test_receiver r;
+
+    em->attach(r);
+    shared_ptr<void> obj{ move(em) };
+    EXPECT_FALSE(em_ptr->send_shared(&test_emitter_signals::delete_obj, ref(obj)));
+    EXPECT_TRUE(r.empty());
+}
+
+TEST(emitting, produces_lazy_arguments_once_for_attached_transmitters)
+{
+    emitter<test_emitter_signals> em;
+    test_receiver r1, r2, subscriber;
+    test_proxy p;
+    size_t calls = 0;
+    auto producer = [&] { ++calls; return string("text"); };
+
+    EXPECT_TRUE(em.send_lazy(&test_emitter_signals::take_text, producer));
+    em.attach(subscriber, &test_emitter_signals::some_signal);
+    EXPECT_TRUE(em.send_lazy(&test_emitter_signals::take_text, producer));
+    EXPECT_EQ(0u, calls);
+
+    em.attach(r1);
+    em.attach(p);
+    em.attach(r2);
+    EXPECT_TRUE(em.send_lazy(&test_emitter_signals::take_text, producer));
+    EXPECT_EQ(1u, calls);
+    EXPECT_EQ("text", r1.text);
+    EXPECT_EQ("text", r2.text);
+    EXPECT_EQ("text", p._receiver.text);
+    EXPECT_FALSE(subscriber.received);
+}
+
+TEST(emitting, produces_lazy_argument_tuple)
+{
+    emitter<test_emitter_signals> em, target;
+    test_receiver r, target_receiver;
+    test_proxy p;
+
+    em.attach(r);
+    em.attach(p);
+    target.attach(target_receiver);
+    EXPECT_TRUE(em.send_lazy(&test_emitter_signals::send_signal, [&] {
+        return tuple(ref(target), packed_signal<test_emitter_signals>(&test_emitter_signals::some_signal));
+    }));
+    EXPECT_TRUE(target_receiver.received);
+}
+
+TEST(emitting, can_subscribe_to_particular_signals)
+{
+    emitter<test_emitter_signals> em;
+    test_receiver r1, r2;
+
+    em.attach(r1);
+    em.attach(r2, &test_emitter_signals::some_signal, &test_emitter_signals::take_text);
+    EXPECT_EQ(3u, em.size());
+    EXPECT_FALSE(r2.empty());
+
+    size_t copies = 0;
+    EXPECT_TRUE(em.send(&test_emitter_signals::count_copies, copy_counter(&copies)));
+    EXPECT_TRUE(r1.received);
+    EXPECT_FALSE(r2.received);
+
+    EXPECT_TRUE(em.send(&test_emitter_signals::take_text, string("text")));
+    EXPECT_EQ("text", r1.text);
+    EXPECT_EQ("text", r2.text);
+
+    r2.received = false;
+    EXPECT_TRUE(em.send_shared(&test_emitter_signals::some_signal));
+    EXPECT_TRUE(r2.received);
+}
+
+TEST(emitting, forwards_packed_signals_to_subscribers)
+{
+    emitter<test_emitter_signals> em;
+    test_receiver r;
+
+    em.attach(r, &test_emitter_signals::some_signal);
+    EXPECT_TRUE(em.send(packed_signal<test_emitter_signals>(bind(&test_emitter_signals::some_signal, placeholders::_1))));
+    EXPECT_FALSE(r.received);
+    EXPECT_TRUE(em.send(packed_signal<test_emitter_signals>(&test_emitter_signals::some_signal)));
+    EXPECT_TRUE(r.received);
+}
+
+TEST(emitting, sends_batches_to_transmitters_and_subscribers)
+{
+    emitter<test_emitter_signals> em;
+    test_receiver all, subscribed;
+    em.attach(all);
+    em.attach(subscribed, &test_emitter_signals::take_text);
+
+    vector<packed_signal<test_emitter_signals>> calls;
+    calls.emplace_back(&test_emitter_signals::some_signal);
+    calls.emplace_back(&test_emitter_signals::take_text, string("text"));
+    EXPECT_TRUE(em.send_batch(calls));
+    EXPECT_TRUE(all.received);
+    EXPECT_EQ("text", all.text);
+    EXPECT_EQ("text", subscribed.text);
+}
+
+TEST(emitting, can_detach_subscriptions)
+{
+    emitter<test_emitter_signals> em;
+    test_receiver r1, r2;
+
+    em.attach(r1, &test_emitter_signals::some_signal, &test_emitter_signals::take_text);
+    em.attach(r2, &test_emitter_signals::some_signal);
+    EXPECT_THROW(em.detach(r1, &test_emitter_signals::count_copies), transmitter_not_attached);
+
+    em.detach(r1, &test_emitter_signals::some_signal);
+    EXPECT_EQ(2u, em.size());
+    EXPECT_TRUE(em.send(&test_emitter_signals::some_signal));
+    EXPECT_FALSE(r1.received);
+    EXPECT_TRUE(r2.received);
+
+    em.detach(r1);
+    EXPECT_TRUE(r1.empty());
+    EXPECT_THROW(em.detach(r1), transmitter_not_attached);
+
+    em.attach(r1, &test_emitter_signals::some_signal, &test_emitter_signals::take_text);
+    EXPECT_EQ(3u, em.size());
+    em.detach(r1);
+    EXPECT_TRUE(r1.empty());
+    EXPECT_EQ(1u, em.size());
+    EXPECT_TRUE(em.send(&test_emitter_signals::some_signal));
+    EXPECT_TRUE(em.send(&test_emitter_signals::take_text, string("text")));
+    EXPECT_FALSE(r1.received);
+    EXPECT_TRUE(r1.text.empty());
+
+    {
+        test_receiver r3;
+        em.attach(r3, &test_emitter_signals::take_text);
+        EXPECT_EQ(2u, em.size());
+    }
+    EXPECT_EQ(1u, em.size());
+
+    em.reset();
+    EXPECT_TRUE(em.empty());
+    EXPECT_TRUE(r2.empty());
+}
+
+TEST(emitting, emitter_copies_subscriptions)
+{
+    emitter<test_emitter_signals> em1;
+    test_receiver r;
+
+    em1.attach(r, &test_emitter_signals::some_signal);
+    emitter<test_emitter_signals> em2(em1);
+    emitter<test_emitter_signals> em3(move(em1));
+    EXPECT_TRUE(em1.empty());
+    EXPECT_EQ(1u, em2.size());
+    EXPECT_EQ(1u, em3.size());
+
+    em2.detach(r);
+    EXPECT_TRUE(em3.send(&test_emitter_signals::some_signal));
+    EXPECT_TRUE(r.received);
+}
+
+TEST(emitting, can_send_signals_in_parallel)
+{
+    emitter<test_emitter_signals> em;
+    vector<unique_ptr<test_receiver>> receivers;
+    vector<unique_ptr<test_proxy>> proxies;
+    for (size_t i = 0; i < 32; ++i) {
+        receivers.push_back(make_unique<test_receiver>());
+        em.attach(*receivers.back());
+        proxies.push_back(make_unique<test_proxy>());
+        em.attach(*proxies.back(), &test_emitter_signals::take_text);
+    }
+    em.detach(*receivers.front());
+
+    thread_pool pool(4);
+    EXPECT_TRUE(em.send_parallel(pool, &test_emitter_signals::take_text, string("text")));
+    EXPECT_EQ("", receivers.front()->text);
+    for (size_t i = 1; i < 32; ++i)
+        EXPECT_EQ("text", receivers[i]->text);
+    for (auto& proxy : proxies)
+        EXPECT_EQ("text", proxy->_receiver.text);
+
+    sequential_executor executor;
+    proxies.front()->_receiver.received = false;
+    EXPECT_TRUE(em.send_parallel(executor, &test_emitter_signals::some_signal));
+    EXPECT_FALSE(proxies.front()->_receiver.received);
+}
+
+TEST(emitting, can_interrupt_parallel_sending_by_exception_throwing)
+{
+    emitter<test_emitter_signals> em;
+    test_receiver r1, r2;
+    size_t counter = 1;
+
+    em.attach(r1);
+    em.attach(r2);
+    sequential_executor executor;
+    EXPECT_THROW(em.send_parallel(executor, &test_emitter_signals::throw_at, ref(counter)), runtime_error);
+    EXPECT_TRUE(r1.received);
+    EXPECT_FALSE(r2.received);
+}
+
+TEST(emitting, does_not_send_parallel_signal_to_transmitters_detached_while_sending)
+{
+    emitter<test_emitter_signals> em;
+    test_receiver r1, r2;
+
+    em.attach(r1);
+    em.attach(r2);
+    sequential_executor executor;
+    EXPECT_TRUE(em.send_parallel(executor, &test_emitter_signals::detach_all, ref(em)));
+    EXPECT_TRUE(r1.received);
+    EXPECT_FALSE(r2.received);
+    EXPECT_TRUE(em.empty());
+
+    vector<unique_ptr<test_receiver>> receivers;
+    for (size_t i = 0; i < 64; ++i) {
+        receivers.push_back(make_unique<test_receiver>());
+        em.attach(*receivers.back());
+    }
+    thread_pool pool(4);
+    EXPECT_TRUE(em.send_parallel(pool, &test_emitter_signals::detach_all, ref(em)));
+    EXPECT_TRUE(em.empty());
+    EXPECT_TRUE(receivers.front()->received);
+}
+
+TEST(emitting, can_delete_receiver_while_parallel_sending)
+{
+    emitter<test_emitter_signals> em;
+    test_receiver r1;
+    auto r2 = make_shared<test_receiver>();
+
+    em.attach(r1);
+    em.attach(*r2);
+    shared_ptr<void> obj{ move(r2) };
+    sequential_executor executor;
+    EXPECT_TRUE(em.send_parallel(executor, &test_emitter_signals::delete_obj, ref(obj)));
+    EXPECT_TRUE(r1.received);
+    EXPECT_EQ(1u, em.size());
+}
+
+TEST(emitting, can_delete_emitter_while_parallel_sending)
+{
+    auto em = make_shared<emitter<test_emitter_signals>>();
+    auto* em_ptr = em.get();
+    test_receiver r1, r2;
+
+    em->attach(r1);
+    em->attach(r2);
+    shared_ptr<void> obj{ move(em) };
+    sequential_executor executor;
+    EXPECT_FALSE(em_ptr->send_parallel(executor, &test_emitter_signals::delete_obj, ref(obj)));
+    EXPECT_TRUE(r1.received);
+    EXPECT_FALSE(r2.received);
+    EXPECT_TRUE(r1.empty());
+    EXPECT_TRUE(r2.empty());
+}
+
+TEST(emitting, can_delete_emitter_while_sequential_parallel_sending)
+{
+    auto em = make_shared<emitter<test_emitter_signals>>();
+    auto* em_ptr = em.get();
+    test_receiver r;
+
+    em->attach(r);
+    shared_ptr<void> obj{ move(em) };
+    sequential_executor executor;
+    EXPECT_FALSE(em_ptr->send_parallel(executor, &test_emitter_signals::delete_obj, ref(obj)));
+}
+
+struct test_tick_signals
+{
+    virtual ~test_tick_signals() {}
+
+    virtual void tick(int id, double price) = 0;
+};
+
+struct test_tick_receiver
+    : public test_tick_signals
+    , public transmitter<test_tick_signals>
+{
+    test_tick_receiver(int name, vector<pair<int, int>>& log) : transmitter<test_tick_signals>(this), name(name), log(log) {}
+
+    void tick(int id, double) override { log.emplace_back(name, id); }
+
+    int name;
+    vector<pair<int, int>>& log;
+};
+
+struct test_tick_batch_transmitter
+    : public transmitter<test_tick_signals>
+{
+    void transmit_signal(const packed_signal<test_tick_signals>&) override { ++signals; }
+    void transmit_batch(span<const packed_signal<test_tick_signals>> calls) override { batches.push_back(calls.size()); }
+
+    size_t signals = 0;
+    vector<size_t> batches;
+};
+
+TEST(emitting, can_send_many_signals_in_signal_major_order)
+{
+    vector<pair<int, int>> log;
+    emitter<test_tick_signals> em;
+    test_tick_receiver first(1, log), second(2, log);
+    test_tick_batch_transmitter packed;
+    em.attach(first);
+    em.attach(second);
+    em.attach(packed);
+
+    vector<tuple<int, double>> ticks = {{10, 1.5}, {11, 2.5}};
+    EXPECT_TRUE(em.send_many(&test_tick_signals::tick, ticks));
+    using deliveries = vector<pair<int, int>>;
+    EXPECT_EQ(deliveries({{1, 10}, {2, 10}, {1, 11}, {2, 11}}), log);
+    EXPECT_EQ(2U, packed.signals);
+}
+
+TEST(emitting, can_send_many_signals_in_receiver_major_order)
+{
+    vector<pair<int, int>> log;
+    emitter<test_tick_signals> em;
+    test_tick_receiver first(1, log), second(2, log);
+    test_tick_batch_transmitter packed;
+    em.attach(first);
+    em.attach(second);
+    em.attach(packed);
+
+    vector<tuple<int, double>> ticks = {{10, 1.5}, {11, 2.5}};
+    EXPECT_TRUE(em.send_many(&test_tick_signals::tick, ticks, delivery_order::receiver_major));
+    using deliveries = vector<pair<int, int>>;
+    EXPECT_EQ(deliveries({{1, 10}, {1, 11}, {2, 10}, {2, 11}}), log);
+    EXPECT_EQ(0U, packed.signals);
+    EXPECT_EQ(vector<size_t>({2}), packed.batches);
+}
@@ -20,7 +20,13 @@ License.
 #include <libmodules/receiver.hpp>
 #include <gmock/gmock.h>
 
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace mtl;
 using namespace std;
@@ -194,3 +200,708 @@ TEST(queue_proxy_receiver, can_move_locker)
     EXPECT_TRUE(was_locked);
     EXPECT_EQ(0, lock_count);
 }
+
+TEST(spsc_queue_proxy_receiver, can_queue_signal)
+{
+    spsc_queue_proxy_receiver<test_proxy_receiver_signals> q(1);
+    test_simple_receiver r;
+    q.attach(r);
+    EXPECT_FALSE(q.pop_signal());
+
+    q.transmit_signal(packed_signal<test_proxy_receiver_signals>(&test_proxy_receiver_signals::some_signal, nullptr));
+    EXPECT_FALSE(r.received);
+
+    EXPECT_TRUE(q.pop_signal());
+    EXPECT_TRUE(r.received);
+}
+
+TEST(spsc_queue_proxy_receiver, unable_to_transmit_to_full_queue)
+{
+    spsc_queue_proxy_receiver<test_proxy_receiver_signals> q(1);
+    q.transmit_signal(packed_signal<test_proxy_receiver_signals>(&test_proxy_receiver_signals::some_signal, nullptr));
+    EXPECT_THROW(q.transmit_signal(packed_signal<test_proxy_receiver_signals>(&test_proxy_receiver_signals::some_signal, nullptr)),
+                 signal_queue_overflow);
+}
+
+TEST(mpsc_queue_proxy_receiver, can_queue_signal)
+{
+    mpsc_queue_proxy_receiver<test_proxy_receiver_signals> q;
+    test_simple_receiver r;
+    q.attach(r);
+    EXPECT_FALSE(q.pop_signal());
+
+    q.transmit_signal(packed_signal<test_proxy_receiver_signals>(&test_proxy_receiver_signals::some_signal, nullptr));
+    EXPECT_FALSE(r.received);
+
+    EXPECT_TRUE(q.pop_signal());
+    EXPECT_TRUE(r.received);
+    EXPECT_FALSE(q.pop_signal());
+}
+
+struct test_counting_receiver
+    : public receiver<test_proxy_receiver_signals>
+{
+    vector<int> values;
+
+    void some_signal(unique_ptr<test_filter_proxy_receiver>*) override {}
+    void put(int value) { values.push_back(value); }
+};
+
+packed_signal<test_proxy_receiver_signals> make_put_signal(int value)
+{
+    return packed_signal<test_proxy_receiver_signals>([value](test_proxy_receiver_signals& table) {
+        static_cast<test_counting_receiver&>(table).put(value);
+    });
+}
+
+TEST(bounded_queue_proxy_receiver, fails_on_overflow_by_default)
+{
+    bounded_queue_proxy_receiver<test_proxy_receiver_signals> q(2);
+    test_counting_receiver r;
+    q.attach(r);
+
+    emitter<test_proxy_receiver_signals> em;
+    em.attach(q);
+    em.send(make_put_signal(1));
+    em.send(make_put_signal(2));
+    EXPECT_THROW(em.send(make_put_signal(3)), signal_queue_overflow);
+    EXPECT_EQ(1U, q.dropped());
+    EXPECT_EQ(2U, q.high_water_mark());
+
+    while (q.pop_signal());
+    EXPECT_EQ(vector<int>({1, 2}), r.values);
+}
+
+TEST(bounded_queue_proxy_receiver, can_drop_newest_signals)
+{
+    bounded_queue_proxy_receiver<test_proxy_receiver_signals> q(2, overflow_policy::drop_newest);
+    test_counting_receiver r;
+    q.attach(r);
+
+    for (int value = 1; value <= 4; ++value)
+        q.transmit_signal(make_put_signal(value));
+    EXPECT_EQ(2U, q.dropped());
+
+    while (q.pop_signal());
+    EXPECT_EQ(vector<int>({1, 2}), r.values);
+}
+
+TEST(bounded_queue_proxy_receiver, can_drop_oldest_signals)
+{
+    bounded_queue_proxy_receiver<test_proxy_receiver_signals> q(2, overflow_policy::drop_oldest);
+    test_counting_receiver r;
+    q.attach(r);
+
+    for (int value = 1; value <= 4; ++value)
+        q.transmit_signal(make_put_signal(value));
+    EXPECT_EQ(2U, q.dropped());
+    EXPECT_EQ(2U, q.size());
+
+    while (q.pop_signal());
+    EXPECT_EQ(vector<int>({3, 4}), r.values);
+    EXPECT_EQ(2U, q.high_water_mark());
+}
+
+TEST(bounded_queue_proxy_receiver, can_spill_signals)
+{
+    vector<packed_signal<test_proxy_receiver_signals>> store;
+    bounded_queue_proxy_receiver<test_proxy_receiver_signals> q(1, overflow_policy::spill,
+        [&](packed_signal<test_proxy_receiver_signals> call) { store.push_back(move(call)); });
+    test_counting_receiver r;
+    q.attach(r);
+
+    q.transmit_signal(make_put_signal(1));
+    q.transmit_signal(make_put_signal(2));
+    EXPECT_EQ(1U, store.size());
+    EXPECT_EQ(0U, q.dropped());
+
+    EXPECT_THROW((bounded_queue_proxy_receiver<test_proxy_receiver_signals>(1, overflow_policy::spill)), invalid_argument);
+}
+
+TEST(bounded_queue_proxy_receiver, can_block_producer)
+{
+    bounded_queue_proxy_receiver<test_proxy_receiver_signals> q(1, overflow_policy::block);
+    test_counting_receiver r;
+    q.attach(r);
+
+    thread producer([&] {
+        for (int value = 1; value <= 100; ++value)
+            q.transmit_signal(make_put_signal(value));
+    });
+    while (r.values.size() < 100)
+        if (!q.pop_signal())
+            this_thread::yield();
+    producer.join();
+
+    EXPECT_EQ(0U, q.dropped());
+    EXPECT_EQ(1U, q.high_water_mark());
+    for (int value = 1; value <= 100; ++value)
+        ASSERT_EQ(value, r.values[value - 1]);
+}
+
+TEST(queue_proxy_receiver, can_drain_signals_by_batches)
+{
+    queue_proxy_receiver<test_proxy_receiver_signals, mutex> q;
+    test_counting_receiver r;
+    q.attach(r);
+    EXPECT_EQ(0U, q.drain_all());
+
+    for (int value = 1; value <= 5; ++value)
+        q.transmit_signal(make_put_signal(value));
+    EXPECT_EQ(2U, q.drain(2));
+    EXPECT_EQ(vector<int>({1, 2}), r.values);
+
+    // Signals transmitted after the batch was taken are transmitted after the rest of batch
+    q.transmit_signal(make_put_signal(6));
+    EXPECT_TRUE(q.pop_signal());
+    EXPECT_EQ(3U, q.drain_all());
+    EXPECT_EQ(vector<int>({1, 2, 3, 4, 5, 6}), r.values);
+    EXPECT_FALSE(q.pop_signal());
+}
+
+TEST(queue_proxy_receiver, can_limit_drain_by_time_budget)
+{
+    queue_proxy_receiver<test_proxy_receiver_signals> q;
+    test_counting_receiver r;
+    q.attach(r);
+
+    for (int value = 1; value <= 3; ++value)
+        q.transmit_signal(make_put_signal(value));
+    EXPECT_EQ(1U, q.drain(10, chrono::nanoseconds(0)));
+    EXPECT_EQ(2U, q.drain(10, chrono::seconds(10)));
+    EXPECT_EQ(vector<int>({1, 2, 3}), r.values);
+}
+
+template<typename wait_strategy_type>
+struct queue_waiting
+    : public testing::Test
+{
+    using queue_type = queue_proxy_receiver<test_proxy_receiver_signals, mutex, wait_strategy_type>;
+};
+
+#if defined(__linux__)
+using wait_strategies = testing::Types<spin_wait, spin_yield_wait, blocking_wait, eventfd_wait>;
+#else
+using wait_strategies = testing::Types<spin_wait, spin_yield_wait, blocking_wait>;
+#endif
+TYPED_TEST_SUITE(queue_waiting, wait_strategies);
+
+TYPED_TEST(queue_waiting, can_wait_for_signal)
+{
+    typename TestFixture::queue_type q;
+    test_counting_receiver r;
+    q.attach(r);
+
+    thread producer([&] {
+        for (int value = 1; value <= 100; ++value)
+            q.transmit_signal(make_put_signal(value));
+    });
+    for (int value = 1; value <= 100; ++value)
+        ASSERT_TRUE(q.wait_pop());
+    producer.join();
+
+    for (int value = 1; value <= 100; ++value)
+        ASSERT_EQ(value, r.values[value - 1]);
+}
+
+TYPED_TEST(queue_waiting, can_wait_with_timeout)
+{
+    typename TestFixture::queue_type q;
+    test_counting_receiver r;
+    q.attach(r);
+
+    EXPECT_FALSE(q.wait_pop_for(chrono::milliseconds(1)));
+    q.transmit_signal(make_put_signal(1));
+    EXPECT_TRUE(q.wait_pop_for(chrono::milliseconds(1)));
+    EXPECT_EQ(vector<int>({1}), r.values);
+}
+
+TYPED_TEST(queue_waiting, can_wake_up_consumer)
+{
+    typename TestFixture::queue_type q;
+    thread waker([&] {
+        this_thread::sleep_for(chrono::milliseconds(1));
+        q.wakeup();
+    });
+    EXPECT_FALSE(q.wait_pop());
+    waker.join();
+}
+
+TYPED_TEST(queue_waiting, transmits_queued_signals_after_shutdown)
+{
+    typename TestFixture::queue_type q;
+    test_counting_receiver r;
+    q.attach(r);
+
+    q.transmit_signal(make_put_signal(1));
+    q.shutdown();
+    EXPECT_TRUE(q.is_shut_down());
+    EXPECT_TRUE(q.wait_pop());
+    EXPECT_FALSE(q.wait_pop());
+    EXPECT_FALSE(q.wait_pop());
+    EXPECT_EQ(vector<int>({1}), r.values);
+}
+
+struct test_priority_signals
+{
+    virtual ~test_priority_signals() {}
+
+    vector<int> values;
+
+    virtual void control(int value) { values.push_back(value); }
+    virtual void telemetry(int value) { values.push_back(value); }
+};
+
+struct test_priority_receiver
+    : public test_priority_signals
+    , public transmitter<test_priority_signals>
+{
+    test_priority_receiver() : transmitter<test_priority_signals>(this) {}
+};
+
+TEST(priority_queue_proxy_receiver, pops_signals_by_priority)
+{
+    priority_queue_proxy_receiver<test_priority_signals> q;
+    q.set_priority(&test_priority_signals::control, 0);
+    test_priority_receiver r;
+    q.attach(r);
+
+    emitter<test_priority_signals> em;
+    em.attach(q);
+    em.send(&test_priority_signals::telemetry, 1);
+    em.send(&test_priority_signals::telemetry, 2);
+    em.send(&test_priority_signals::control, 3);
+    q.transmit_signal(packed_signal<test_priority_signals>(&test_priority_signals::telemetry, 4), 1);
+    em.send(&test_priority_signals::control, 5);
+    EXPECT_EQ(5U, q.size());
+
+    while (q.pop_signal());
+    EXPECT_EQ(vector<int>({3, 5, 4, 1, 2}), r.values);
+    EXPECT_EQ(0U, q.size());
+}
+
+TEST(priority_queue_proxy_receiver, protects_low_priority_signals_from_starvation)
+{
+    priority_queue_proxy_receiver<test_priority_signals, 2> q(1, 2);
+    q.set_priority(&test_priority_signals::control, 0);
+    test_priority_receiver r;
+    q.attach(r);
+
+    q.transmit_signal(packed_signal<test_priority_signals>(&test_priority_signals::telemetry, 100));
+    for (int value = 0; value < 4; ++value)
+        q.transmit_signal(packed_signal<test_priority_signals>(&test_priority_signals::control, value));
+
+    while (q.pop_signal());
+    EXPECT_EQ(vector<int>({0, 1, 100, 2, 3}), r.values);
+}
+
+struct test_manual_clock
+{
+    using duration = chrono::milliseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = chrono::time_point<test_manual_clock>;
+    static constexpr bool is_steady = true;
+
+    explicit test_manual_clock(time_point* current) : current(current) {}
+    time_point now() const { return *current; }
+
+    time_point* current;
+};
+
+TEST(delayed_proxy_receiver, transmits_signals_after_delay)
+{
+    test_manual_clock::time_point now;
+    delayed_proxy_receiver<test_proxy_receiver_signals, test_manual_clock> q(chrono::milliseconds(1), test_manual_clock(&now));
+    test_counting_receiver r;
+    q.attach(r);
+
+    q.transmit_signal_after(make_put_signal(2), chrono::milliseconds(20));
+    q.transmit_signal_at(make_put_signal(1), now + chrono::milliseconds(10));
+    q.transmit_signal_after(make_put_signal(3), chrono::seconds(30));
+    EXPECT_EQ(3U, q.size());
+
+    now += chrono::milliseconds(9);
+    EXPECT_EQ(0U, q.poll());
+    now += chrono::milliseconds(1);
+    EXPECT_EQ(1U, q.poll());
+    now += chrono::milliseconds(15);
+    EXPECT_EQ(1U, q.poll());
+    EXPECT_EQ(vector<int>({1, 2}), r.values);
+
+    now += chrono::seconds(30);
+    EXPECT_EQ(1U, q.poll());
+    EXPECT_EQ(vector<int>({1, 2, 3}), r.values);
+    EXPECT_EQ(0U, q.size());
+}
+
+TEST(delayed_proxy_receiver, can_cancel_signals)
+{
+    test_manual_clock::time_point now;
+    delayed_proxy_receiver<test_proxy_receiver_signals, test_manual_clock> q(chrono::milliseconds(1), test_manual_clock(&now));
+    test_counting_receiver r;
+    q.attach(r);
+
+    auto id = q.transmit_signal_after(make_put_signal(1), chrono::milliseconds(5));
+    q.transmit_signal_after(make_put_signal(2), chrono::milliseconds(5));
+    EXPECT_TRUE(q.cancel(id));
+    EXPECT_FALSE(q.cancel(id));
+
+    now += chrono::milliseconds(5);
+    q.poll();
+    EXPECT_EQ(vector<int>({2}), r.values);
+}
+
+TEST(delayed_proxy_receiver, transmits_periodic_signals)
+{
+    test_manual_clock::time_point now;
+    delayed_proxy_receiver<test_proxy_receiver_signals, test_manual_clock> q(chrono::milliseconds(10), test_manual_clock(&now));
+    test_counting_receiver r;
+    q.attach(r);
+
+    auto id = q.transmit_signal_every(make_put_signal(1), chrono::milliseconds(100), chrono::milliseconds(0));
+    for (int step = 0; step < 35; ++step) {
+        now += chrono::milliseconds(10);
+        q.poll();
+    }
+    EXPECT_EQ(4U, r.values.size());
+
+    // Late poll transmits missed signals and keeps the schedule
+    now += chrono::milliseconds(250);
+    EXPECT_EQ(2U, q.poll());
+    now += chrono::milliseconds(50);
+    EXPECT_EQ(1U, q.poll());
+
+    EXPECT_TRUE(q.cancel(id));
+    now += chrono::seconds(1);
+    EXPECT_EQ(0U, q.poll());
+}
+
+TEST(delayed_proxy_receiver, can_be_polled_while_polling)
+{
+    test_manual_clock::time_point now;
+    delayed_proxy_receiver<test_proxy_receiver_signals, test_manual_clock> q(chrono::milliseconds(1), test_manual_clock(&now));
+    test_counting_receiver r;
+    q.attach(r);
+
+    q.transmit_signal_after(make_put_signal(1), chrono::milliseconds(1));
+    q.transmit_signal_after(packed_signal<test_proxy_receiver_signals>([&](test_proxy_receiver_signals&) {
+        q.transmit_signal(make_put_signal(3));
+        now += chrono::milliseconds(1);
+        EXPECT_EQ(1U, q.poll());
+    }), chrono::milliseconds(1));
+    q.transmit_signal_after(make_put_signal(2), chrono::milliseconds(1));
+
+    now += chrono::milliseconds(1);
+    EXPECT_EQ(3U, q.poll());
+    EXPECT_EQ(vector<int>({1, 3, 2}), r.values);
+}
+
+TEST(delayed_proxy_receiver, stops_polling_when_destroyed)
+{
+    test_manual_clock::time_point now;
+    using delayed_receiver = delayed_proxy_receiver<test_proxy_receiver_signals, test_manual_clock>;
+    auto q = make_unique<delayed_receiver>(chrono::milliseconds(1), test_manual_clock(&now));
+    test_counting_receiver r;
+    q->attach(r);
+
+    q->transmit_signal_after(make_put_signal(1), chrono::milliseconds(1));
+    q->transmit_signal_after(packed_signal<test_proxy_receiver_signals>([&](test_proxy_receiver_signals&) { q.reset(); }),
+                             chrono::milliseconds(1));
+    q->transmit_signal_after(make_put_signal(2), chrono::milliseconds(1));
+
+    now += chrono::milliseconds(1);
+    EXPECT_EQ(2U, q->poll());
+    EXPECT_FALSE(q);
+    EXPECT_EQ(vector<int>({1}), r.values);
+}
+
+TEST(delayed_proxy_receiver, transmits_emitted_signals_at_next_tick)
+{
+    test_manual_clock::time_point now;
+    delayed_proxy_receiver<test_proxy_receiver_signals, test_manual_clock, mutex> q(chrono::milliseconds(1), test_manual_clock(&now));
+    test_counting_receiver r;
+    q.attach(r);
+
+    emitter<test_proxy_receiver_signals> em;
+    em.attach(q);
+    em.send(make_put_signal(1));
+    EXPECT_EQ(0U, q.poll());
+    now += chrono::milliseconds(1);
+    EXPECT_EQ(1U, q.poll());
+    EXPECT_EQ(vector<int>({1}), r.values);
+}
+
+struct test_update_signals
+{
+    virtual ~test_update_signals() {}
+
+    vector<pair<string, int>> updates;
+
+    virtual void price(const string& symbol, int value) { updates.emplace_back(symbol, value); }
+    virtual void status(int value) { updates.emplace_back("status", value); }
+    virtual void trade(int value) { updates.emplace_back("trade", value); }
+};
+
+struct test_update_receiver
+    : public test_update_signals
+    , public transmitter<test_update_signals>
+{
+    test_update_receiver() : transmitter<test_update_signals>(this) {}
+};
+
+TEST(conflating_queue_proxy_receiver, keeps_latest_signal_per_key)
+{
+    conflating_queue_proxy_receiver<test_update_signals> q;
+    q.conflate(&test_update_signals::price, [](const string& symbol, int) { return symbol; });
+    q.conflate(&test_update_signals::status);
+    test_update_receiver r;
+    q.attach(r);
+
+    emitter<test_update_signals> em;
+    em.attach(q);
+    em.send(&test_update_signals::price, string("A"), 1);
+    em.send(&test_update_signals::status, 1);
+    em.send(&test_update_signals::price, "B", 1);
+    em.send(&test_update_signals::trade, 1);
+    em.send(&test_update_signals::price, "A", 2);
+    em.send(&test_update_signals::status, 2);
+    em.send(&test_update_signals::trade, 2);
+    em.send(&test_update_signals::price, "A", 3);
+    EXPECT_EQ(5U, q.size());
+    EXPECT_EQ(3U, q.conflated());
+
+    while (q.pop_signal());
+    using updates = vector<pair<string, int>>;
+    EXPECT_EQ(updates({{"A", 3}, {"status", 2}, {"B", 1}, {"trade", 1}, {"trade", 2}}), r.updates);
+
+    // Popped signal is not replaced by the newer one
+    em.send(&test_update_signals::price, "A", 4);
+    q.pop_signal();
+    em.send(&test_update_signals::price, "A", 5);
+    EXPECT_EQ(1U, q.size());
+    q.pop_signal();
+    EXPECT_EQ(updates({{"A", 4}, {"A", 5}}), updates(r.updates.end() - 2, r.updates.end()));
+}
+
+TEST(conflating_queue_proxy_receiver, queues_signals_without_key_as_usual)
+{
+    conflating_queue_proxy_receiver<test_update_signals> q;
+    q.conflate(&test_update_signals::status, [](int value) { return value % 2; });
+    EXPECT_THROW(q.conflate(&test_update_signals::status), logic_error);
+    test_update_receiver r;
+    q.attach(r);
+
+    q.transmit_signal(packed_signal<test_update_signals>(bind(&test_update_signals::status, placeholders::_1, 1)));
+    q.transmit_signal(packed_signal<test_update_signals>(&test_update_signals::status, 1));
+    q.transmit_signal(packed_signal<test_update_signals>(&test_update_signals::status, 2));
+    q.transmit_signal(packed_signal<test_update_signals>(&test_update_signals::status, 3));
+    EXPECT_EQ(3U, q.size());
+
+    while (q.pop_signal());
+    using updates = vector<pair<string, int>>;
+    EXPECT_EQ(updates({{"status", 1}, {"status", 3}, {"status", 2}}), r.updates);
+}
+
+TEST(typed_queue_proxy_receiver, queues_listed_signals_without_packing)
+{
+    typed_queue_proxy_receiver<test_update_signals, signal_list<&test_update_signals::price, &test_update_signals::status>, mutex> q;
+    test_update_receiver r;
+    q.attach(r);
+
+    emitter<test_update_signals> em;
+    em.attach(q);
+    em.send(&test_update_signals::price, "A", 1);
+    q.transmit_signal(&test_update_signals::status, 2);
+    em.send(&test_update_signals::trade, 3);
+    EXPECT_EQ(3U, q.size());
+
+    EXPECT_TRUE(q.pop_signal());
+    q.transmit_signal(&test_update_signals::price, "B", 4);
+    EXPECT_EQ(3U, q.drain_all());
+    EXPECT_FALSE(q.pop_signal());
+
+    using updates = vector<pair<string, int>>;
+    EXPECT_EQ(updates({{"A", 1}, {"status", 2}, {"trade", 3}, {"B", 4}}), r.updates);
+}
+
+TEST(typed_queue_proxy_receiver, stops_draining_when_destroyed)
+{
+    using typed_receiver = typed_queue_proxy_receiver<test_update_signals, signal_list<&test_update_signals::status>>;
+    auto q = make_unique<typed_receiver>();
+    test_update_receiver r;
+    q->attach(r);
+
+    q->transmit_signal(&test_update_signals::status, 1);
+    q->transmit_signal(packed_signal<test_update_signals>([&](test_update_signals&) { q.reset(); }));
+    q->transmit_signal(&test_update_signals::status, 2);
+    EXPECT_EQ(2U, q->drain_all());
+    EXPECT_FALSE(q);
+
+    using updates = vector<pair<string, int>>;
+    EXPECT_EQ(updates({{"status", 1}}), r.updates);
+}
+
+struct test_buffer_signals
+{
+    virtual ~test_buffer_signals() {}
+
+    vector<int> values;
+
+    virtual void buffer(unique_ptr<vector<int>> data) { values.insert(values.end(), data->begin(), data->end()); }
+};
+
+struct test_buffer_receiver
+    : public test_buffer_signals
+    , public transmitter<test_buffer_signals>
+{
+    test_buffer_receiver() : transmitter<test_buffer_signals>(this) {}
+};
+
+template<typename queue_type>
+struct move_only_queuing
+    : public testing::Test
+{};
+
+using move_only_queue_types = testing::Types<queue_proxy_receiver<test_buffer_signals>,
+                                             priority_queue_proxy_receiver<test_buffer_signals>,
+                                             mpsc_queue_proxy_receiver<test_buffer_signals>,
+                                             typed_queue_proxy_receiver<test_buffer_signals, signal_list<&test_buffer_signals::buffer>>>;
+TYPED_TEST_SUITE(move_only_queuing, move_only_queue_types);
+
+TYPED_TEST(move_only_queuing, transfers_move_only_arguments)
+{
+    TypeParam q;
+    test_buffer_receiver r;
+    q.attach(r);
+
+    emitter<test_buffer_signals> em;
+    em.attach(q);
+    em.send(&test_buffer_signals::buffer, make_unique<vector<int>>(vector<int>{1, 2}));
+    em.send(packed_signal<test_buffer_signals>(&test_buffer_signals::buffer, make_unique<vector<int>>(vector<int>{3})));
+
+    while (q.pop_signal());
+    EXPECT_EQ(vector<int>({1, 2, 3}), r.values);
+}
+
+TEST(typed_queue_proxy_receiver, stores_move_only_arguments_typed)
+{
+    typed_queue_proxy_receiver<test_buffer_signals, signal_list<&test_buffer_signals::buffer>> q;
+    test_buffer_receiver r;
+    q.attach(r);
+
+    q.transmit_signal(&test_buffer_signals::buffer, make_unique<vector<int>>(vector<int>{1}));
+    q.transmit_signal(packed_signal<test_buffer_signals>(&test_buffer_signals::buffer, make_unique<vector<int>>(vector<int>{2})));
+    EXPECT_EQ(2U, q.drain_all());
+    EXPECT_EQ(vector<int>({1, 2}), r.values);
+}
+
+TEST(bounded_queue_proxy_receiver, spills_move_only_signals)
+{
+    vector<packed_signal<test_buffer_signals>> store;
+    bounded_queue_proxy_receiver<test_buffer_signals> q(1, overflow_policy::spill,
+        [&](packed_signal<test_buffer_signals> call) { store.push_back(move(call)); });
+    test_buffer_receiver r;
+    q.attach(r);
+
+    emitter<test_buffer_signals> em;
+    em.attach(q);
+    em.send(&test_buffer_signals::buffer, make_unique<vector<int>>(vector<int>{1}));
+    em.send(&test_buffer_signals::buffer, make_unique<vector<int>>(vector<int>{2}));
+    ASSERT_EQ(1U, store.size());
+
+    while (q.pop_signal());
+    store.front()(r);
+    EXPECT_EQ(vector<int>({1, 2}), r.values);
+}
+
+TEST(queue_proxy_receiver, unable_to_copy_move_only_signal)
+{
+    queue_proxy_receiver<test_buffer_signals> first, second;
+    emitter<test_buffer_signals> em;
+    em.attach(first);
+    em.attach(second);
+
+    // Only the last transmitter could take the signal
+    EXPECT_THROW(em.send(&test_buffer_signals::buffer, make_unique<vector<int>>()), signal_not_copyable);
+}
+
+TEST(bounded_queue_proxy_receiver, transfers_move_only_arguments)
+{
+    bounded_queue_proxy_receiver<test_buffer_signals> q(2);
+    test_buffer_receiver r;
+    q.attach(r);
+
+    emitter<test_buffer_signals> em;
+    em.attach(q);
+    em.send(&test_buffer_signals::buffer, make_unique<vector<int>>(vector<int>{1, 2}));
+    q.transmit_signal(packed_signal<test_buffer_signals>(&test_buffer_signals::buffer, make_unique<vector<int>>(vector<int>{3})));
+
+    while (q.pop_signal());
+    EXPECT_EQ(vector<int>({1, 2, 3}), r.values);
+}
+
+TEST(priority_queue_proxy_receiver, transfers_move_only_arguments_with_priority)
+{
+    priority_queue_proxy_receiver<test_buffer_signals> q;
+    test_buffer_receiver r;
+    q.attach(r);
+
+    q.transmit_signal(packed_signal<test_buffer_signals>(&test_buffer_signals::buffer, make_unique<vector<int>>(vector<int>{2})), 2);
+    q.transmit_signal(packed_signal<test_buffer_signals>(&test_buffer_signals::buffer, make_unique<vector<int>>(vector<int>{1})), 0);
+
+    while (q.pop_signal());
+    EXPECT_EQ(vector<int>({1, 2}), r.values);
+}
+
+TEST(delayed_proxy_receiver, transfers_move_only_arguments)
+{
+    test_manual_clock::time_point now;
+    delayed_proxy_receiver<test_buffer_signals, test_manual_clock> q(chrono::milliseconds(1), test_manual_clock(&now));
+    test_buffer_receiver r;
+    q.attach(r);
+
+    auto data = make_unique<vector<int>>(vector<int>{3});
+    q.transmit_signal_at(packed_signal<test_buffer_signals>(&test_buffer_signals::buffer, make_unique<vector<int>>(vector<int>{1})),
+                         now + chrono::milliseconds(1));
+    q.transmit_signal_after(packed_signal<test_buffer_signals>(&test_buffer_signals::buffer, make_unique<vector<int>>(vector<int>{2})),
+                            chrono::milliseconds(2));
+    auto id = q.transmit_signal_every(packed_signal<test_buffer_signals>([data = std::move(data)](test_buffer_signals& t) {
+                                          t.values.insert(t.values.end(), data->begin(), data->end());
+                                      }),
+                                      chrono::milliseconds(2));
+
+    for (int step = 0; step < 4; ++step) {
+        now += chrono::milliseconds(1);
+        q.poll();
+    }
+    EXPECT_TRUE(q.cancel(id));
+    EXPECT_EQ(vector<int>({1, 2, 3, 3}), r.values);
+}
+
+struct test_batch_counting_receiver
+    : public batch_receiver<test_proxy_receiver_signals>
+{
+    vector<size_t> batches;
+
+    void some_signal(unique_ptr<test_filter_proxy_receiver>*) override {}
+
+protected:
+    void receive_batch(span<const packed_signal<test_proxy_receiver_signals>> calls) override { batches.push_back(calls.size()); }
+};
+
+TEST(queue_proxy_receiver, can_pop_signals_by_batches)
+{
+    queue_proxy_receiver<test_proxy_receiver_signals> q;
+    proxy_receiver<test_proxy_receiver_signals> forwarder;
+    test_batch_counting_receiver r;
+    q.attach(forwarder);
+    forwarder.attach(r);
+
+    EXPECT_EQ(0U, q.pop_batch());
+    for (int index = 0; index < 5; ++index)
+        q.transmit_signal(packed_signal<test_proxy_receiver_signals>(&test_proxy_receiver_signals::some_signal, nullptr));
+    EXPECT_EQ(3U, q.pop_batch(3));
+    EXPECT_EQ(2U, q.pop_batch());
+    EXPECT_EQ(vector<size_t>({3, 2}), r.batches);
+}
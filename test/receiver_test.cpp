@@ -19,6 +19,9 @@ License.
 #include <libmodules/receiver.hpp>
 #include <gmock/gmock.h>
 
+#include <span>
+#include <vector>
+
 using namespace mtl;
 using namespace std;
 
@@ -48,3 +51,48 @@ TEST(receiver, copy_operators_does_not_copy_transmitters)
     receiver<test_receiver_signals> r_move = move(r);
     EXPECT_EQ(&static_cast<test_receiver_signals&>(r_move), r_move.get());
 }
+
+struct test_batch_signals
+{
+    virtual ~test_batch_signals() {}
+
+    virtual void write(int value) = 0;
+    virtual void flush() = 0;
+};
+
+struct test_batch_receiver
+    : public batch_receiver<test_batch_signals>
+{
+    vector<vector<int>> writes;
+    size_t flushes = 0;
+
+    void write(int value) override { writes.push_back({value}); }
+    void flush() override          { ++flushes; }
+
+protected:
+    void receive_batch(span<const packed_signal<test_batch_signals>> calls) override
+    {
+        if (calls.front().signal() != signal_id<test_batch_signals>(&test_batch_signals::write))
+            return batch_receiver<test_batch_signals>::receive_batch(calls);
+
+        vector<int> values;
+        for (const auto& call : calls)
+            call.visit(&test_batch_signals::write, [&](int value) { values.push_back(value); });
+        writes.push_back(values);
+    }
+};
+
+TEST(batch_receiver, receives_runs_of_one_signal)
+{
+    vector<packed_signal<test_batch_signals>> calls;
+    calls.emplace_back(&test_batch_signals::write, 1);
+    calls.emplace_back(&test_batch_signals::write, 2);
+    calls.emplace_back(&test_batch_signals::flush);
+    calls.emplace_back(&test_batch_signals::flush);
+    calls.emplace_back(&test_batch_signals::write, 3);
+
+    test_batch_receiver r;
+    r.transmit_batch(calls);
+    EXPECT_EQ(vector<vector<int>>({{1, 2}, {3}}), r.writes);
+    EXPECT_EQ(2U, r.flushes);
+}
@@ -0,0 +1,319 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+
+#include <libmodules/signal_queue.hpp>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+using namespace std;
+
+struct queue_signal_table
+{
+    virtual ~queue_signal_table() {}
+
+    vector<int> values;
+
+    virtual void put(int value) { values.push_back(value); }
+};
+
+TEST(spsc_signal_queue, rounds_capacity_up_to_power_of_two)
+{
+    EXPECT_EQ(1U, spsc_signal_queue<queue_signal_table>(0).capacity());
+    EXPECT_EQ(8U, spsc_signal_queue<queue_signal_table>(5).capacity());
+    EXPECT_EQ(8U, spsc_signal_queue<queue_signal_table>(8).capacity());
+}
+
+TEST(spsc_signal_queue, keeps_signal_order)
+{
+    spsc_signal_queue<queue_signal_table> queue(4);
+    packed_signal<queue_signal_table> call;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop(call));
+
+    for (int value = 0; value < 4; ++value)
+        EXPECT_TRUE(queue.push(packed_signal<queue_signal_table>(&queue_signal_table::put, value)));
+    EXPECT_FALSE(queue.push(packed_signal<queue_signal_table>(&queue_signal_table::put, 4)));
+    EXPECT_EQ(4U, queue.size());
+
+    queue_signal_table table;
+    while (queue.pop(call))
+        call(table);
+    EXPECT_EQ(vector<int>({0, 1, 2, 3}), table.values);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(spsc_signal_queue, passes_signals_between_threads)
+{
+    const int count = 100000;
+    spsc_signal_queue<queue_signal_table> queue(64);
+    thread producer([&] {
+        for (int value = 0; value < count; ++value)
+            while (!queue.push(packed_signal<queue_signal_table>(&queue_signal_table::put, value)))
+                this_thread::yield();
+    });
+
+    queue_signal_table table;
+    packed_signal<queue_signal_table> call;
+    while (table.values.size() < count)
+        if (queue.pop(call))
+            call(table);
+        else
+            this_thread::yield();
+    producer.join();
+
+    for (int value = 0; value < count; ++value)
+        ASSERT_EQ(value, table.values[value]);
+}
+
+TEST(mpsc_signal_queue, keeps_signal_order)
+{
+    mpsc_signal_queue<queue_signal_table> queue;
+    packed_signal<queue_signal_table> call;
+    EXPECT_FALSE(queue.pop(call));
+
+    for (int value = 0; value < 3; ++value)
+        queue.push(packed_signal<queue_signal_table>(&queue_signal_table::put, value));
+
+    queue_signal_table table;
+    while (queue.pop(call))
+        call(table);
+    EXPECT_EQ(vector<int>({0, 1, 2}), table.values);
+}
+
+TEST(mpsc_signal_queue, keeps_order_of_each_producer)
+{
+    const int producers = 4;
+    const int count = 20000;
+    mpsc_signal_queue<queue_signal_table> queue;
+    vector<thread> threads;
+    for (int producer = 0; producer < producers; ++producer)
+        threads.emplace_back([&, producer] {
+            for (int value = 0; value < count; ++value)
+                queue.push(packed_signal<queue_signal_table>(&queue_signal_table::put, producer * count + value));
+        });
+
+    queue_signal_table table;
+    packed_signal<queue_signal_table> call;
+    while (table.values.size() < producers * count)
+        if (queue.pop(call))
+            call(table);
+        else
+            this_thread::yield();
+    for (auto& producer : threads)
+        producer.join();
+
+    vector<int> last(producers, -1);
+    for (int value : table.values) {
+        ASSERT_LT(last[value / count], value % count);
+        last[value / count] = value % count;
+    }
+}
+
+TEST(mpsc_signal_queue, deletes_queued_signals)
+{
+    auto counter = make_shared<int>(0);
+    {
+        mpsc_signal_queue<queue_signal_table> queue;
+        queue.push(packed_signal<queue_signal_table>([counter](queue_signal_table&) {}));
+        EXPECT_EQ(2, counter.use_count());
+    }
+    EXPECT_EQ(1, counter.use_count());
+}
+
+struct pool_test_node
+{
+    atomic<uint32_t> next_free{0};
+};
+
+TEST(node_pool, allocates_preallocated_nodes)
+{
+    node_pool<pool_test_node> pool(2);
+    EXPECT_EQ(2U, pool.size());
+
+    auto* first = pool.allocate();
+    auto* second = pool.allocate();
+    ASSERT_TRUE(first && second);
+    EXPECT_NE(first, second);
+    EXPECT_TRUE(pool.owns(first));
+    EXPECT_EQ(nullptr, pool.allocate());
+
+    pool_test_node other;
+    EXPECT_FALSE(pool.owns(&other));
+
+    pool.release(first);
+    EXPECT_EQ(first, pool.allocate());
+    EXPECT_EQ(nullptr, node_pool<pool_test_node>(0).allocate());
+}
+
+TEST(node_pool, shares_nodes_between_threads)
+{
+    node_pool<pool_test_node> pool(16);
+    vector<thread> threads;
+    atomic<int> failures{0};
+    for (int index = 0; index < 4; ++index)
+        threads.emplace_back([&] {
+            for (int iteration = 0; iteration < 10000; ++iteration) {
+                auto* first = pool.allocate();
+                auto* second = pool.allocate();
+                if (!first || !second || first == second)
+                    ++failures;
+                if (first)
+                    pool.release(first);
+                if (second)
+                    pool.release(second);
+            }
+        });
+    for (auto& t : threads)
+        t.join();
+    EXPECT_EQ(0, failures);
+}
+
+TEST(mpsc_signal_queue, uses_heap_when_pool_is_exhausted)
+{
+    mpsc_signal_queue<queue_signal_table> queue(2);
+    EXPECT_EQ(2U, queue.preallocated());
+
+    for (int round = 0; round < 3; ++round) {
+        for (int value = 0; value < 4; ++value)
+            queue.push(packed_signal<queue_signal_table>(&queue_signal_table::put, value));
+
+        queue_signal_table table;
+        packed_signal<queue_signal_table> call;
+        while (queue.pop(call))
+            call(table);
+        EXPECT_EQ(vector<int>({0, 1, 2, 3}), table.values);
+    }
+}
+
+TEST(signal_ring, grows_and_keeps_signal_order)
+{
+    signal_ring<queue_signal_table> ring;
+    packed_signal<queue_signal_table> call;
+    EXPECT_FALSE(ring.pop(call));
+
+    queue_signal_table table;
+    int next = 0;
+    // Wrap the ring before it grows
+    for (int value = 0; value < 40; ++value) {
+        ring.push(packed_signal<queue_signal_table>(&queue_signal_table::put, value));
+        if (value % 3 == 0 && ring.pop(call)) {
+            call(table);
+            ++next;
+        }
+    }
+    EXPECT_EQ(40U - next, ring.size());
+    while (ring.pop(call))
+        call(table);
+
+    ASSERT_EQ(40U, table.values.size());
+    for (int value = 0; value < 40; ++value)
+        ASSERT_EQ(value, table.values[value]);
+}
+
+struct typed_signal_table
+{
+    virtual ~typed_signal_table() {}
+
+    vector<string> log;
+
+    virtual void put(int value) { log.push_back(to_string(value)); }
+    virtual void name(const string& text, int value) { log.push_back(text + to_string(value)); }
+    virtual void share(shared_ptr<int> data) { log.push_back("shared" + to_string(*data)); }
+    virtual void other(int value) { log.push_back("other" + to_string(value)); }
+};
+
+using typed_queue = typed_signal_queue<typed_signal_table, signal_list<&typed_signal_table::put, &typed_signal_table::name,
+                                                                     &typed_signal_table::share>>;
+
+struct typed_queue_consumer
+{
+    typed_signal_table& table;
+    size_t packed = 0;
+
+    template<typename FnType, typename... Args>
+    void operator ()(FnType signal_name, Args&&... args) { (table.*signal_name)(std::forward<Args>(args)...); }
+    void operator ()(packed_signal<typed_signal_table>&& call) { ++packed; call(table); }
+};
+
+TEST(typed_signal_queue, keeps_signal_order)
+{
+    typed_queue queue;
+    EXPECT_TRUE(queue.empty());
+
+    queue.push(&typed_signal_table::put, 1);
+    queue.push(&typed_signal_table::name, "a", 2);
+    queue.push(packed_signal<typed_signal_table>(&typed_signal_table::put, 3));
+    queue.push(&typed_signal_table::other, 4);
+    queue.push(packed_signal<typed_signal_table>(bind(&typed_signal_table::put, placeholders::_1, 5)));
+    EXPECT_EQ(5U, queue.size());
+
+    typed_signal_table table;
+    typed_queue_consumer consumer{table};
+    while (queue.pop(consumer));
+    EXPECT_EQ(vector<string>({"1", "a2", "3", "other4", "5"}), table.log);
+    // Not listed signal and callable object are stored packed
+    EXPECT_EQ(2U, consumer.packed);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(typed_signal_queue, wraps_and_grows_ring)
+{
+    typed_queue queue;
+    typed_signal_table table;
+    typed_queue_consumer consumer{table};
+    vector<string> expected;
+
+    int next = 0;
+    for (int round = 0; round < 50; ++round) {
+        for (int index = 0; index < round; ++index) {
+            queue.push(&typed_signal_table::name, string(next % 7, 'x'), next);
+            expected.push_back(string(next % 7, 'x') + to_string(next));
+            ++next;
+        }
+        for (int index = 0; index < round / 2 + 1; ++index)
+            queue.pop(consumer);
+    }
+    while (queue.pop(consumer));
+    EXPECT_EQ(expected, table.log);
+    EXPECT_GT(queue.capacity(), 0U);
+}
+
+TEST(typed_signal_queue, releases_arguments)
+{
+    auto data = make_shared<int>(1);
+    {
+        typed_queue queue;
+        queue.push(&typed_signal_table::share, data);
+        queue.push(&typed_signal_table::share, data);
+        EXPECT_EQ(3, data.use_count());
+
+        typed_signal_table table;
+        typed_queue_consumer consumer{table};
+        queue.pop(consumer);
+        EXPECT_EQ(2, data.use_count());
+    }
+    EXPECT_EQ(1, data.use_count());
+}
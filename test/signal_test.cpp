@@ -0,0 +1,217 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+
+#include <libmodules/signal.hpp>
+#include <gmock/gmock.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+using namespace mtl;
+using namespace std;
+
+struct test_signal_table
+{
+    virtual ~test_signal_table() {}
+
+    int value = 0;
+    string text;
+
+    virtual void set_value(int v) { value = v; }
+    virtual void set_text(const string& t, int v) { text = t; value = v; }
+    virtual void increment(int& counter) { ++counter; }
+    virtual void sum(array<int, 32> values) { for (int v : values) value += v; }
+    virtual void take(unique_ptr<int> data) { value = *data; }
+};
+
+TEST(packed_signal, is_empty_by_default)
+{
+    packed_signal<test_signal_table> call;
+    test_signal_table table;
+    EXPECT_FALSE(call);
+    EXPECT_THROW(call(table), bad_function_call);
+}
+
+TEST(packed_signal, fits_into_cache_line)
+{
+    EXPECT_GE(64u, sizeof(packed_signal<test_signal_table>));
+}
+
+TEST(packed_signal, can_pack_signal_with_arguments)
+{
+    packed_signal<test_signal_table> call(&test_signal_table::set_text, string("text"), 5);
+    EXPECT_TRUE(call);
+    EXPECT_TRUE(call.is_inline());
+
+    test_signal_table table;
+    call(table);
+    EXPECT_EQ("text", table.text);
+    EXPECT_EQ(5, table.value);
+}
+
+TEST(packed_signal, can_pack_reference)
+{
+    int counter = 0;
+    packed_signal<test_signal_table> call(&test_signal_table::increment, ref(counter));
+
+    test_signal_table table;
+    call(table);
+    call(table);
+    EXPECT_EQ(2, counter);
+}
+
+TEST(packed_signal, can_pack_callable_object)
+{
+    packed_signal<test_signal_table> call(bind(&test_signal_table::set_value, placeholders::_1, 7));
+    EXPECT_TRUE(call.is_inline());
+
+    test_signal_table table;
+    call(table);
+    EXPECT_EQ(7, table.value);
+}
+
+TEST(packed_signal, stores_large_arguments_in_heap)
+{
+    array<int, 32> values;
+    values.fill(1);
+    packed_signal<test_signal_table> call(&test_signal_table::sum, values);
+    EXPECT_FALSE(call.is_inline());
+
+    test_signal_table table;
+    call(table);
+    EXPECT_EQ(32, table.value);
+}
+
+TEST(packed_signal, buffer_size_could_be_specified)
+{
+    array<int, 32> values;
+    values.fill(1);
+    packed_signal<test_signal_table, 256> call(&test_signal_table::sum, values);
+    EXPECT_TRUE(call.is_inline());
+
+    test_signal_table table;
+    call(table);
+    EXPECT_EQ(32, table.value);
+}
+
+TEST(packed_signal, can_copy_and_move)
+{
+    array<int, 32> values;
+    values.fill(1);
+    packed_signal<test_signal_table> small(&test_signal_table::set_value, 3);
+    packed_signal<test_signal_table> large(&test_signal_table::sum, values);
+
+    packed_signal<test_signal_table> small_copy(small);
+    packed_signal<test_signal_table> large_copy(large);
+    EXPECT_TRUE(small);
+    EXPECT_TRUE(large);
+
+    packed_signal<test_signal_table> small_moved(move(small_copy));
+    packed_signal<test_signal_table> large_moved(move(large_copy));
+    EXPECT_FALSE(small_copy);
+    EXPECT_FALSE(large_copy);
+
+    swap(small_moved, large_moved);
+    test_signal_table table;
+    small_moved(table);
+    EXPECT_EQ(32, table.value);
+    large_moved(table);
+    EXPECT_EQ(3, table.value);
+
+    small_moved = large;
+    small_moved(table);
+    EXPECT_EQ(35, table.value);
+
+    small_moved = nullptr;
+    EXPECT_FALSE(small_moved);
+}
+
+TEST(packed_signal, releases_arguments)
+{
+    auto data = make_shared<int>(0);
+    {
+        packed_signal<test_signal_table> call(bind([](test_signal_table&, shared_ptr<int>) {}, placeholders::_1, data));
+        packed_signal<test_signal_table> copy(call);
+        EXPECT_EQ(3, data.use_count());
+    }
+    EXPECT_EQ(1, data.use_count());
+}
+
+TEST(packed_signal, knows_signal_method)
+{
+    packed_signal<test_signal_table> empty;
+    packed_signal<test_signal_table> method(&test_signal_table::set_value, 1);
+    packed_signal<test_signal_table> callable(bind(&test_signal_table::set_value, placeholders::_1, 1));
+
+    EXPECT_FALSE(empty.signal());
+    EXPECT_TRUE(signal_id<test_signal_table>(&test_signal_table::set_value) == method.signal());
+    EXPECT_TRUE(signal_id<test_signal_table>(&test_signal_table::set_text) != method.signal());
+    EXPECT_FALSE(callable.signal());
+}
+
+TEST(packed_signal, signal_could_be_hash_key)
+{
+    unordered_map<signal_id<test_signal_table>, int> signals;
+    signals[&test_signal_table::set_value] = 1;
+    signals[&test_signal_table::set_text] = 2;
+
+    EXPECT_EQ(2U, signals.size());
+    EXPECT_EQ(1, signals[packed_signal<test_signal_table>(&test_signal_table::set_value, 1).signal()]);
+    EXPECT_EQ(signal_id<test_signal_table>(&test_signal_table::set_text).hash(), std::hash<signal_id<test_signal_table>>()(&test_signal_table::set_text));
+}
+
+TEST(packed_signal, can_visit_arguments)
+{
+    packed_signal<test_signal_table> method(&test_signal_table::set_text, "text", 5);
+    packed_signal<test_signal_table> callable(bind(&test_signal_table::set_value, placeholders::_1, 1));
+
+    string text;
+    int value = 0;
+    EXPECT_TRUE(method.visit(&test_signal_table::set_text, [&](const string& t, int v) { text = t; value = v; }));
+    EXPECT_EQ("text", text);
+    EXPECT_EQ(5, value);
+
+    EXPECT_FALSE(method.visit(&test_signal_table::set_value, [&](int v) { value = v; }));
+    EXPECT_FALSE(callable.visit(&test_signal_table::set_value, [&](int v) { value = v; }));
+    EXPECT_EQ(5, value);
+}
+
+TEST(packed_signal, can_pack_move_only_arguments)
+{
+    packed_signal<test_signal_table> call(&test_signal_table::take, make_unique<int>(7));
+    EXPECT_TRUE(call.is_inline());
+    EXPECT_FALSE(call.is_copyable());
+    EXPECT_THROW(packed_signal<test_signal_table> copy(call), signal_not_copyable);
+
+    packed_signal<test_signal_table> moved(std::move(call));
+    EXPECT_FALSE(call);
+    test_signal_table table;
+    moved(table);
+    EXPECT_EQ(7, table.value);
+    EXPECT_THROW(moved(table), signal_not_copyable);
+
+    auto data = make_unique<int>(8);
+    packed_signal<test_signal_table> callable([data = std::move(data)](test_signal_table& t) { t.set_value(*data); });
+    EXPECT_FALSE(callable.is_copyable());
+    callable(table);
+    EXPECT_EQ(8, table.value);
+
+    EXPECT_TRUE(packed_signal<test_signal_table>(&test_signal_table::set_value, 1).is_copyable());
+}
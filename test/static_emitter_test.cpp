@@ -0,0 +1,99 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+
+#include <libmodules/static_emitter.hpp>
+#include <gmock/gmock.h>
+
+#include <string>
+#include <vector>
+
+using namespace mtl;
+using namespace std;
+
+struct test_static_signals
+{
+    virtual ~test_static_signals() {}
+
+    virtual void some_signal(int id, vector<int>& order) = 0;
+    virtual void text_signal(string text) = 0;
+};
+
+struct test_static_receiver final
+    : public test_static_signals
+{
+    int id = 0;
+    string text;
+
+    test_static_receiver(int id) : id(id) {}
+
+    void some_signal(int, vector<int>& order) override { order.push_back(id); }
+    void text_signal(string t) override                { text = move(t); }
+};
+
+struct other_static_receiver final
+    : public test_static_signals
+{
+    bool received = false;
+
+    void some_signal(int, vector<int>& order) override { received = true; order.push_back(-1); }
+    void text_signal(string) override                  { received = true; }
+};
+
+TEST(static_emitter, has_receivers_count)
+{
+    test_static_receiver r1(1), r2(2);
+    static_emitter<test_static_signals> empty_em;
+    static_emitter<test_static_signals, test_static_receiver, test_static_receiver> em(r1, r2);
+    EXPECT_TRUE(empty_em.empty());
+    EXPECT_EQ(0u, empty_em.size());
+    EXPECT_FALSE(em.empty());
+    EXPECT_EQ(2u, em.size());
+}
+
+TEST(static_emitter, sends_signals_in_receivers_order)
+{
+    test_static_receiver r1(1), r2(2);
+    other_static_receiver r3;
+    static_emitter<test_static_signals, test_static_receiver, other_static_receiver, test_static_receiver> em(r2, r3, r1);
+
+    vector<int> order;
+    EXPECT_TRUE(em.send(&test_static_signals::some_signal, 0, ref(order)));
+    EXPECT_EQ(vector<int>({2, -1, 1}), order);
+    EXPECT_TRUE(r3.received);
+}
+
+TEST(static_emitter, does_not_move_out_arguments)
+{
+    test_static_receiver r1(1), r2(2);
+    static_emitter<test_static_signals, test_static_receiver, test_static_receiver> em(r1, r2);
+
+    EXPECT_TRUE(em.send(&test_static_signals::text_signal, string("text")));
+    EXPECT_EQ("text", r1.text);
+    EXPECT_EQ("text", r2.text);
+}
+
+TEST(static_emitter, can_forward_packed_signals)
+{
+    test_static_receiver r1(1), r2(2);
+    static_emitter<test_static_signals, test_static_receiver, test_static_receiver> em(r1, r2);
+
+    vector<int> order;
+    EXPECT_TRUE(em.send(packed_signal<test_static_signals>(&test_static_signals::some_signal, 0, ref(order))));
+    EXPECT_TRUE(em.send(packed_signal<test_static_signals>()));
+    EXPECT_EQ(vector<int>({1, 2}), order);
+}
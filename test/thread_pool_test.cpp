@@ -0,0 +1,120 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+
+#include <libmodules/thread_pool.hpp>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace mtl;
+using namespace std;
+
+TEST(sequential_executor, executes_tasks_in_order)
+{
+    sequential_executor executor;
+    vector<size_t> order;
+    executor.bulk_execute(3, [&](size_t index) { order.push_back(index); });
+    EXPECT_EQ(vector<size_t>({0, 1, 2}), order);
+}
+
+TEST(thread_pool, has_at_least_one_thread)
+{
+    thread_pool pool(0);
+    EXPECT_EQ(1u, pool.size());
+}
+
+TEST(thread_pool, executes_posted_tasks)
+{
+    atomic<int> counter{0};
+    {
+        thread_pool pool(4);
+        for (int i = 0; i < 100; ++i)
+            pool.post([&] { ++counter; });
+    }
+    EXPECT_EQ(100, counter);
+}
+
+TEST(thread_pool, runs_deferred_task_after_own_tasks)
+{
+    vector<int> order;
+    {
+        thread_pool pool(1);
+        pool.post([&] {
+            pool.post([&] { order.push_back(1); });
+            pool.defer([&] { order.push_back(3); });
+            pool.post([&] { order.push_back(2); });
+        });
+    }
+    EXPECT_EQ(vector<int>({2, 1, 3}), order);
+}
+
+TEST(thread_pool, worker_can_run_pending_tasks)
+{
+    vector<int> order;
+    {
+        thread_pool pool(1);
+        EXPECT_FALSE(pool.run_pending());
+        pool.post([&] {
+            pool.post([&] { order.push_back(1); });
+            EXPECT_TRUE(pool.run_pending());
+            EXPECT_FALSE(pool.run_pending());
+            order.push_back(2);
+        });
+    }
+    EXPECT_EQ(vector<int>({1, 2}), order);
+}
+
+TEST(thread_pool, executes_each_index_once)
+{
+    thread_pool pool(4);
+    vector<atomic<int>> calls(1000);
+    pool.bulk_execute(calls.size(), [&](size_t index) { ++calls[index]; });
+    for (auto& count : calls)
+        EXPECT_EQ(1, count);
+
+    EXPECT_NO_THROW(pool.bulk_execute(0, [&](size_t) { throw runtime_error("Unexpected call."); }));
+}
+
+TEST(thread_pool, can_execute_nested_tasks)
+{
+    thread_pool pool(2);
+    atomic<int> counter{0};
+    pool.bulk_execute(10, [&](size_t) {
+        pool.bulk_execute(10, [&](size_t) { ++counter; });
+    });
+    EXPECT_EQ(100, counter);
+}
+
+TEST(thread_pool, rethrows_task_exception)
+{
+    thread_pool pool(4);
+    atomic<int> counter{0};
+    EXPECT_THROW(pool.bulk_execute(1000, [&](size_t index) {
+        ++counter;
+        if (index == 10)
+            throw runtime_error("Something bad happened.");
+    }), runtime_error);
+    EXPECT_LE(11, counter);
+
+    // Pool is still usable
+    counter = 0;
+    pool.bulk_execute(10, [&](size_t) { ++counter; });
+    EXPECT_EQ(10, counter);
+}
@@ -0,0 +1,127 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+
+#include <libmodules/threaded_receiver.hpp>
+#include <libmodules/concurrent_emitter.hpp>
+#include <libmodules/receiver.hpp>
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+using namespace std;
+
+struct threaded_signals
+{
+    virtual ~threaded_signals() {}
+
+    virtual void put(int value) = 0;
+};
+
+struct threaded_test_receiver
+    : public receiver<threaded_signals>
+{
+    vector<int> values;
+    vector<thread::id> threads;
+
+    void put(int value) override
+    {
+        values.push_back(value);
+        threads.push_back(this_thread::get_id());
+    }
+};
+
+TEST(threaded_receiver, processes_signals_in_worker_thread)
+{
+    threaded_test_receiver r;
+    threaded_receiver<threaded_signals> worker;
+    worker.attach(r);
+
+    emitter<threaded_signals> em;
+    em.attach(worker);
+
+    worker.start();
+    EXPECT_TRUE(worker.running());
+    for (int value = 1; value <= 100; ++value)
+        em.send(&threaded_signals::put, value);
+    worker.stop();
+    EXPECT_FALSE(worker.running());
+
+    ASSERT_EQ(100U, r.values.size());
+    for (int value = 1; value <= 100; ++value)
+        ASSERT_EQ(value, r.values[value - 1]);
+    for (auto id : r.threads)
+        ASSERT_NE(this_thread::get_id(), id);
+}
+
+TEST(threaded_receiver, keeps_signals_until_start)
+{
+    threaded_test_receiver r;
+    threaded_receiver<threaded_signals> worker;
+    worker.attach(r);
+
+    worker.transmit_signal(packed_signal<threaded_signals>(&threaded_signals::put, 1));
+    EXPECT_TRUE(r.values.empty());
+
+    worker.start();
+    worker.stop(false);
+    worker.start();
+    worker.stop();
+    EXPECT_EQ(vector<int>({1}), r.values);
+}
+
+TEST(threaded_receiver, receives_signals_of_many_threads)
+{
+    threaded_test_receiver r;
+    threaded_receiver<threaded_signals, spin_yield_wait> worker;
+    worker.attach(r);
+    concurrent_emitter<threaded_signals> em;
+    em.attach(worker);
+    worker.start();
+
+    vector<thread> producers;
+    for (int producer = 0; producer < 4; ++producer)
+        producers.emplace_back([&, producer] {
+            for (int value = 0; value < 1000; ++value)
+                em.send(&threaded_signals::put, producer * 1000 + value);
+        });
+    for (auto& producer : producers)
+        producer.join();
+    worker.stop();
+
+    ASSERT_EQ(4000U, r.values.size());
+    vector<int> last(4, -1);
+    for (int value : r.values) {
+        ASSERT_LT(last[value / 1000], value % 1000);
+        last[value / 1000] = value % 1000;
+    }
+}
+
+TEST(threaded_receiver, drains_signals_at_destruction)
+{
+    threaded_test_receiver r;
+    {
+        threaded_receiver<threaded_signals> worker;
+        worker.attach(r);
+        worker.start();
+        for (int value = 1; value <= 10; ++value)
+            worker.transmit_signal(packed_signal<threaded_signals>(&threaded_signals::put, value));
+    }
+    EXPECT_EQ(10U, r.values.size());
+}
@@ -0,0 +1,143 @@
+/* -*- mode: c++; c-file-style: "bsd"; c++-basic-offset: 4; indent-tabs-mode nil -*- */
+/***************************************************************************************************
+
+Project libmodule
+Copyright 2018 Sergey Ushakov
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under the License is
+distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+implied.  See the License for the specific language governing permissions and limitations under the
+License.
+***************************************************************************************************/
+
+#include <libmodules/timer_wheel.hpp>
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using namespace mtl;
+using namespace std;
+
+TEST(timer_wheel, fires_timers_at_expiry)
+{
+    timer_wheel<int> wheel;
+    wheel.schedule(3, 0, 3);
+    wheel.schedule(1, 0, 1);
+    wheel.schedule(70, 0, 70);
+    wheel.schedule(5000, 0, 5000);
+    wheel.schedule(300000, 0, 300000);
+    EXPECT_EQ(5U, wheel.size());
+
+    using fired_timers = vector<pair<uint64_t, int>>;
+    fired_timers fired;
+    auto on_expired = [&](int value) { fired.emplace_back(wheel.now(), value); };
+    wheel.advance(2, on_expired);
+    EXPECT_EQ(fired_timers({{1, 1}}), fired);
+
+    wheel.advance(300000, on_expired);
+    EXPECT_EQ(fired_timers({{1, 1}, {3, 3}, {70, 70}, {5000, 5000}, {300000, 300000}}), fired);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(timer_wheel, fires_expired_timer_at_next_tick)
+{
+    timer_wheel<int> wheel;
+    wheel.advance(10, [](int) {});
+    wheel.schedule(5, 0, 5);
+
+    vector<uint64_t> fired;
+    wheel.advance(11, [&](int) { fired.push_back(wheel.now()); });
+    EXPECT_EQ(vector<uint64_t>({11}), fired);
+}
+
+TEST(timer_wheel, keeps_scheduling_order_of_simultaneous_timers)
+{
+    timer_wheel<int> wheel;
+    wheel.schedule(200, 0, 1);
+    wheel.advance(150, [](int) {});
+    wheel.schedule(200, 0, 2);
+    wheel.schedule(200, 0, 3);
+
+    vector<int> fired;
+    wheel.advance(200, [&](int value) { fired.push_back(value); });
+    EXPECT_EQ(vector<int>({1, 2, 3}), fired);
+}
+
+TEST(timer_wheel, can_cancel_timers)
+{
+    timer_wheel<int> wheel;
+    auto first = wheel.schedule(10, 0, 1);
+    auto second = wheel.schedule(10000, 0, 2);
+    wheel.schedule(10, 0, 3);
+
+    EXPECT_TRUE(wheel.cancel(first));
+    EXPECT_FALSE(wheel.cancel(first));
+    EXPECT_TRUE(wheel.cancel(second));
+    EXPECT_FALSE(wheel.cancel(0));
+
+    vector<int> fired;
+    wheel.advance(20000, [&](int value) { fired.push_back(value); });
+    EXPECT_EQ(vector<int>({3}), fired);
+
+    // Record of the cancelled timer is reused with the new generation
+    auto third = wheel.schedule(20010, 0, 4);
+    EXPECT_NE(first, third);
+    EXPECT_FALSE(wheel.cancel(first));
+    EXPECT_TRUE(wheel.cancel(third));
+}
+
+TEST(timer_wheel, reschedules_periodic_timers)
+{
+    timer_wheel<int> wheel;
+    auto id = wheel.schedule(5, 100, 1);
+
+    vector<uint64_t> fired;
+    wheel.advance(400, [&](int) { fired.push_back(wheel.now()); });
+    EXPECT_EQ(vector<uint64_t>({5, 105, 205, 305}), fired);
+    EXPECT_EQ(1U, wheel.size());
+
+    EXPECT_TRUE(wheel.cancel(id));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(timer_wheel, can_hold_timers_beyond_its_range)
+{
+    timer_wheel<int> wheel;
+    uint64_t far = (uint64_t(1) << 37) + 5;
+    wheel.schedule(far, 0, 1);
+
+    vector<uint64_t> fired;
+    wheel.advance(far - 1, [&](int) { fired.push_back(wheel.now()); });
+    EXPECT_TRUE(fired.empty());
+    wheel.advance(far, [&](int) { fired.push_back(wheel.now()); });
+    EXPECT_EQ(vector<uint64_t>({far}), fired);
+}
+
+TEST(timer_wheel, can_be_copied_and_moved)
+{
+    timer_wheel<int> wheel;
+    wheel.schedule(1, 0, 1);
+    auto id = wheel.schedule(2, 0, 2);
+    wheel.schedule(100, 0, 100);
+
+    timer_wheel<int> copy(wheel);
+    EXPECT_TRUE(copy.cancel(id));
+    EXPECT_EQ(3U, wheel.size());
+
+    vector<int> fired;
+    wheel.advance(100, [&](int value) { fired.push_back(value); });
+    EXPECT_EQ(vector<int>({1, 2, 100}), fired);
+
+    timer_wheel<int> moved(std::move(copy));
+    fired.clear();
+    moved.advance(100, [&](int value) { fired.push_back(value); });
+    EXPECT_EQ(vector<int>({1, 100}), fired);
+}